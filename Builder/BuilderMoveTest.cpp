@@ -0,0 +1,146 @@
+#include <common.h>
+#include <gtest/gtest.h>
+#include <sstream>
+
+#include "Person.h"
+#include "PersonBuilder.h"
+#include "PersonAddressBuilder.h"
+#include "PersonJobBuilder.h"
+#include "Lectures/lecture_07_fluent_builder.h"
+#define COUNT_ALLOCATIONS
+#include "Lectures/bench_util.h"
+
+/**
+ * A builder is usually thrown away as soon as it is done, so handing over what it built should move it, not copy
+ * it. These tests count the heap allocations made by the last steps of building a Person and an HtmlElement.
+ * Every string is too long for the small string optimization, so that copying one would allocate.
+ */
+static string long_string(const string &s) {
+    return s + string(32, '.');
+}
+
+static string print(const Person &p) {
+    ostringstream out;
+    out << p;
+    return out.str();
+}
+
+TEST(BuilderMoveTests, PersonChainMovesEverything) {
+    auto name = long_string("Felix Yagunglepuss"), street = long_string("123 London Road");
+    auto post_code = long_string("SW1 1GB"), city = long_string("London");
+    auto company = long_string("Pragmasoft"), position = long_string("Consultant");
+
+    auto before = heap_stats.allocations;
+    Person p = Person::create()
+            .named(std::move(name))
+            .lives().at(std::move(street))
+                    .with_postcode(std::move(post_code))
+                    .in(std::move(city))
+            .works().at(std::move(company))
+                    .as_a(std::move(position))
+                    .earning(1e7);
+    auto made = heap_stats.allocations - before;
+
+    EXPECT_EQ(0, made);
+    EXPECT_NE(string::npos, print(p).find(long_string("Felix Yagunglepuss")));
+    EXPECT_NE(string::npos, print(p).find(long_string("Consultant")));
+}
+
+TEST(BuilderMoveTests, NamedPersonBuilderCopiesUnlessMoved) {
+    auto builder = Person::create();
+    builder.named(long_string("Felix Yagunglepuss")).lives().in(long_string("London"));
+
+    auto before = heap_stats.allocations;
+    Person copy = builder;
+    auto copied = heap_stats.allocations - before;
+
+    before = heap_stats.allocations;
+    Person moved = std::move(builder).build();
+    auto made = heap_stats.allocations - before;
+
+    EXPECT_EQ(2, copied);
+    EXPECT_EQ(0, made);
+    EXPECT_EQ(print(copy), print(moved));
+}
+
+TEST(BuilderMoveTests, SubBuilderOfNamedPersonBuilderCopies) {
+    auto builder = Person::create();
+    builder.named(long_string("Felix Yagunglepuss"));
+
+    // The sub-builders are temporaries, but the person they build belongs to builder, which is still usable.
+    Person a = builder.lives().in(long_string("London"));
+    Person b = builder.works().at(long_string("Pragmasoft"));
+    Person all = builder;
+
+    EXPECT_NE(string::npos, print(a).find(long_string("Felix Yagunglepuss")));
+    EXPECT_NE(string::npos, print(b).find(long_string("London")));
+    EXPECT_NE(string::npos, print(all).find(long_string("Felix Yagunglepuss")));
+    EXPECT_NE(string::npos, print(all).find(long_string("London")));
+    EXPECT_NE(string::npos, print(all).find(long_string("Pragmasoft")));
+
+    // Moving the builder itself lets its sub-builders move the person out.
+    auto position = long_string("Consultant");
+    auto before = heap_stats.allocations;
+    Person moved = std::move(builder).works().as_a(std::move(position));
+    auto made = heap_stats.allocations - before;
+
+    EXPECT_EQ(0, made);
+    EXPECT_NE(string::npos, print(moved).find(long_string("Pragmasoft")));
+}
+
+TEST(BuilderMoveTests, HtmlChainMovesChildren) {
+    auto first = long_string("hello"), second = long_string("world");
+
+    auto before = heap_stats.allocations;
+    HtmlElement ul = HtmlElement::create("ul")
+            .addChild("li", std::move(first))
+            .addChild("li", std::move(second));
+    auto made = heap_stats.allocations - before;
+
+    // Only the vector of children grows: to hold one element, then two.
+    EXPECT_EQ(2, made);
+    EXPECT_EQ("<ul>\n"
+              "  <li>\n    " + long_string("hello") + "\n  </li>\n"
+              "  <li>\n    " + long_string("world") + "\n  </li>\n"
+              "</ul>\n", ul.str());
+}
+
+TEST(BuilderMoveTests, NamedHtmlBuilderCopiesUnlessMoved) {
+    auto builder = HtmlElement::create("ul");
+    for (int i = 0; i < 4; ++i)
+        builder.addChild("li", long_string(to_string(i)));
+    auto before = heap_stats.allocations;
+    HtmlElement copy = builder;
+    auto copied = heap_stats.allocations - before;
+
+    before = heap_stats.allocations;
+    HtmlElement moved = std::move(builder);
+    auto made = heap_stats.allocations - before;
+
+    // The copy needs a vector of children and the text of each.
+    EXPECT_EQ(5, copied);
+    EXPECT_EQ(0, made);
+    EXPECT_EQ(copy.str(), moved.str());
+}
+
+TEST(BuilderMoveTests, NestedBuilderMovesIntoParent) {
+    auto inner = HtmlElement::create("ul");
+    inner.addChild("li", long_string("nested"));
+
+    auto outer = HtmlElement::create("ul");
+    outer.addChild("li", long_string("first"));
+    auto before = heap_stats.allocations;
+    outer.addChild(std::move(inner));
+    auto made = heap_stats.allocations - before;
+
+    // Room for a second child; the nested tree itself is moved.
+    EXPECT_EQ(1, made);
+}
+
+/**
+ * Google tests: can either do this, or omit main and link to gtest_main.
+ */
+int main(int argc, char *argv[]) {
+    testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
@@ -7,20 +7,33 @@ class PersonAddressBuilder : public PersonBuilderBase {
     using Self = PersonAddressBuilder;
 
 public:
-    explicit PersonAddressBuilder(Person &person) : PersonBuilderBase{person} {}
+    explicit PersonAddressBuilder(Person &person, bool moves_person = false)
+            : PersonBuilderBase{person, moves_person} {}
 
-    Self &at(string street_address) {
+    Self &at(string street_address) & {
         person.street_address = std::move(street_address);
         return *this;
     }
 
-    Self &with_postcode(string post_code) {
+    Self &&at(string street_address) && {
+        return std::move(at(std::move(street_address)));
+    }
+
+    Self &with_postcode(string post_code) & {
         person.post_code = std::move(post_code);
         return *this;
     }
 
-    Self &in(string city) {
+    Self &&with_postcode(string post_code) && {
+        return std::move(with_postcode(std::move(post_code)));
+    }
+
+    Self &in(string city) & {
         person.city = std::move(city);
         return *this;
     }
+
+    Self &&in(string city) && {
+        return std::move(in(std::move(city)));
+    }
 };
\ No newline at end of file
@@ -2,21 +2,29 @@
 #include "PersonAddressBuilder.h"
 #include "PersonJobBuilder.h"
 
-PersonBuilderBase::PersonBuilderBase(Person &person) : person(person) {}
+PersonBuilderBase::PersonBuilderBase(Person &person, bool moves_person) : person(person), moves_person(moves_person) {}
 
-PersonAddressBuilder PersonBuilderBase::lives() const {
+PersonAddressBuilder PersonBuilderBase::lives() const & {
     return PersonAddressBuilder{person};
 }
 
-PersonJobBuilder PersonBuilderBase::works() const {
+PersonAddressBuilder PersonBuilderBase::lives() && {
+    return PersonAddressBuilder{person, moves_person};
+}
+
+PersonJobBuilder PersonBuilderBase::works() const & {
     return PersonJobBuilder{person};
 }
 
-PersonBuilder &PersonBuilder::named(std::string name) {
+PersonJobBuilder PersonBuilderBase::works() && {
+    return PersonJobBuilder{person, moves_person};
+}
+
+PersonBuilder &PersonBuilder::named(std::string name) & {
     person.name = std::move(name);
     return *this;
 }
 
 
 
-PersonBuilder::PersonBuilder() : PersonBuilderBase(p) {}
+PersonBuilder::PersonBuilder() : PersonBuilderBase(p, true) {}
@@ -30,18 +30,38 @@ class PersonJobBuilder;
 class PersonBuilderBase {
 protected:
     Person &person;
+
+    // Whether this builder, as an rvalue, may move the person out: only if nothing else will build it any further.
+    // That holds for the PersonBuilder that owns the person, and for the builders lives() and works() return on an
+    // rvalue builder that could; never for those returned on a named one, which is still there to be used.
+    bool moves_person;
 public:
-    PersonBuilderBase(Person &person);
+    PersonBuilderBase(Person &person, bool moves_person = false);
 
     /**
      * To cast the builder to a Person.
+     *
+     * A named builder gives a copy and can keep building. A temporary one, such as the builder at the end of a
+     * Person::create()... chain, hands its person over by moving it, strings and all. So does
+     * std::move(builder).lives()..., but builder.lives()... still copies, as builder owns the person.
      */
-    operator Person() const {
-        return std::move(person);
+    operator Person() const & {
+        return person;
+    }
+
+    operator Person() && {
+        if (moves_person)
+            return std::move(person);
+        return person;
     }
 
-    PersonAddressBuilder lives() const;
-    PersonJobBuilder works() const;
+    Person build() const & { return person; }
+    Person build() && { return std::move(*this); }
+
+    PersonAddressBuilder lives() const &;
+    PersonAddressBuilder lives() &&;
+    PersonJobBuilder works() const &;
+    PersonJobBuilder works() &&;
 };
 
 
@@ -56,7 +76,8 @@ private:
 public:
     PersonBuilder();
 
-    Self &named(std::string name);
+    Self &named(std::string name) &;
+    Self &&named(std::string name) && { return std::move(named(std::move(name))); }
 };
 
 
@@ -0,0 +1,165 @@
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "Person.h"
+#include "PersonBuilder.h"
+#include "PersonAddressBuilder.h"
+#include "PersonJobBuilder.h"
+#include "PersonReader.h"
+#include "PersonTable.h"
+#include "Lectures/worker_pool.h"
+#include "Lectures/bench_util.h"
+
+using namespace std;
+
+/**
+ * The fields of a generated person.
+ */
+struct Row {
+    string name, street_address, post_code, city, company_name, position;
+    int annual_income;
+};
+
+Row row(size_t i) {
+    static const vector<string> first{"Felix", "Ada", "Grace", "Alan", "Edsger", "Barbara", "Donald", "Frances"};
+    static const vector<string> last{"Yagunglepuss", "Lovelace", "Hopper", "Turing", "Dijkstra", "Liskov", "Knuth"};
+    static const vector<string> streets{"London Road", "High Street", "Station Road", "Church Lane", "Mill Lane"};
+    static const vector<string> cities{"London", "Manchester", "Birmingham", "Leeds", "Glasgow", "Bristol",
+                                       "Edinburgh", "Cardiff", "Belfast", "Oxford", "Cambridge", "York"};
+    static const vector<string> positions{"Consultant", "Engineer", "Manager", "Analyst", "Director", "Designer"};
+
+    Row r;
+    r.name = first[i % first.size()] + " " + last[i / first.size() % last.size()] + " " + to_string(i);
+    r.street_address = to_string(1 + i % 400) + " " + streets[i % streets.size()];
+    if (i % 10 == 0)
+        r.street_address += ", Flat " + to_string(1 + i % 7);
+    if (i % 1000 == 0)
+        r.street_address = "The \"Old\" Mill, " + r.street_address;
+    r.post_code = "SW" + to_string(1 + i % 20) + " " + to_string(i % 9) + "GB";
+    r.city = cities[i * 7 % cities.size()];
+    r.company_name = "Company " + to_string(i % 1000);
+    r.position = positions[i % positions.size()];
+    r.annual_income = static_cast<int>(20'000 + i * 7919 % 200'000);
+    return r;
+}
+
+/**
+ * A field as CSV or TSV has it: quoted if it holds the delimiter or a quote.
+ */
+void write_field(ostream &out, const string &field, char delimiter) {
+    if (field.find(delimiter) == string::npos && field.find('"') == string::npos) {
+        out << field;
+        return;
+    }
+    out << '"';
+    for (auto c: field) {
+        if (c == '"')
+            out << '"';
+        out << c;
+    }
+    out << '"';
+}
+
+void write_people(const string &filename, size_t n, char delimiter) {
+    ofstream out{filename, ios::binary};
+    out << "name" << delimiter << "street_address" << delimiter << "post_code" << delimiter << "city" << delimiter
+        << "company_name" << delimiter << "position" << delimiter << "annual_income\n";
+    for (size_t i = 0; i < n; ++i) {
+        auto r = row(i);
+        for (auto field: {&r.name, &r.street_address, &r.post_code, &r.city, &r.company_name, &r.position}) {
+            write_field(out, *field, delimiter);
+            out << delimiter;
+        }
+        out << r.annual_income << '\n';
+    }
+}
+
+string print(const Person &p) {
+    ostringstream out;
+    out << p;
+    return out.str();
+}
+
+bool same(const PersonTable &a, const PersonTable &b) {
+    if (a.size() != b.size())
+        return false;
+    for (size_t i = 0; i < a.size(); ++i) {
+        if (a.name(i) != b.name(i) || a.street_address(i) != b.street_address(i) || a.post_code(i) != b.post_code(i)
+            || a.city(i) != b.city(i) || a.company_name(i) != b.company_name(i) || a.position(i) != b.position(i)
+            || a.annual_income(i) != b.annual_income(i))
+            return false;
+    }
+    return true;
+}
+
+/**
+ * Generates a file of people, reads it into a PersonTable on one thread and on a pool, and reports records per
+ * second. For comparison, it also times building each of them as a Person through the fluent builder, which does
+ * not even include parsing. Checks that both reads agree, and that the people read are the ones written.
+ * Usage: PersonIngest [records] [threads] [csv|tsv]
+ */
+int main(int argc, char *argv[]) {
+    size_t n = argc > 1 ? stoull(argv[1]) : 2'000'000;
+    size_t threads = max<size_t>(1, argc > 2 ? stoull(argv[2]) : thread::hardware_concurrency());
+    bool tsv = argc > 3 && string(argv[3]) == "tsv";
+    char delimiter = tsv ? '\t' : ',';
+    string filename = tsv ? "people.tsv" : "people.csv";
+
+    write_people(filename, n, delimiter);
+
+    auto read = [&](size_t pool_threads) {
+        WorkerPool pool{pool_threads};
+        auto start = chrono::steady_clock::now();
+        auto people = read_people(filename, pool);
+        auto time = seconds_since(start);
+        cout << "  read_people, " << pool_threads << " thread(s): " << time << " s, " << people.size() / time
+             << " records/s" << endl;
+        return people;
+    };
+
+    cout << n << " people in " << filename << endl;
+    auto sequential = read(1);
+    auto parallel = read(threads);
+    remove(filename.c_str());
+
+    auto start = chrono::steady_clock::now();
+    vector<Person> one_at_a_time;
+    one_at_a_time.reserve(parallel.size());
+    for (size_t i = 0; i < parallel.size(); ++i)
+        one_at_a_time.push_back(parallel.person(i));
+    auto time = seconds_since(start);
+    cout << "  Person::create() chain per record, no parsing: " << time << " s, " << parallel.size() / time
+         << " records/s" << endl;
+    cout << "  interned: " << parallel.city_pool().size() << " cities, " << parallel.company_pool().size()
+         << " companies, " << parallel.position_pool().size() << " positions" << endl;
+
+    if (parallel.size() != n || !same(sequential, parallel)) {
+        cerr << "Reading on " << threads << " threads gave different people than on one" << endl;
+        return 1;
+    }
+
+    for (size_t i = 0; i < n; i += max<size_t>(1, n / 1000)) {
+        auto r = row(i);
+        Person expected = Person::create()
+                .named(r.name)
+                .lives().at(r.street_address)
+                        .with_postcode(r.post_code)
+                        .in(r.city)
+                .works().at(r.company_name)
+                        .as_a(r.position)
+                        .earning(r.annual_income);
+        if (print(one_at_a_time[i]) != print(expected)) {
+            cerr << "Person " << i << " was read as:" << endl << one_at_a_time[i] << "but written as:" << endl
+                 << expected;
+            return 1;
+        }
+    }
+
+    return 0;
+}
@@ -7,20 +7,33 @@ class PersonJobBuilder : public PersonBuilderBase {
     using Self = PersonJobBuilder;
 
 public:
-    explicit PersonJobBuilder(Person &person) : PersonBuilderBase{person} {}
+    explicit PersonJobBuilder(Person &person, bool moves_person = false)
+            : PersonBuilderBase{person, moves_person} {}
 
-    Self &at(string company_name) {
+    Self &at(string company_name) & {
         person.company_name = std::move(company_name);
         return *this;
     }
 
-    Self &as_a(string position) {
+    Self &&at(string company_name) && {
+        return std::move(at(std::move(company_name)));
+    }
+
+    Self &as_a(string position) & {
         person.position = std::move(position);
         return *this;
     }
 
-    Self &earning(int annual_income) {
+    Self &&as_a(string position) && {
+        return std::move(as_a(std::move(position)));
+    }
+
+    Self &earning(int annual_income) & {
         person.annual_income = annual_income;
         return *this;
     }
+
+    Self &&earning(int annual_income) && {
+        return std::move(earning(annual_income));
+    }
 };
\ No newline at end of file
@@ -0,0 +1,168 @@
+#include <charconv>
+#include <exception>
+#include <stdexcept>
+#include <system_error>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "PersonReader.h"
+#include "Lectures/worker_pool.h"
+
+static constexpr size_t field_count = 7;
+static constexpr const char *field_names[field_count] = {
+        "name", "street_address", "post_code", "city", "company_name", "position", "annual_income"};
+
+// Chunks smaller than this are not worth a task of their own.
+static constexpr size_t min_chunk = 1 << 20;
+
+[[noreturn]] static void fail(size_t offset, const string &what) {
+    throw runtime_error("at byte " + to_string(offset) + ": " + what);
+}
+
+static string_view without_cr(string_view line) {
+    if (!line.empty() && line.back() == '\r')
+        line.remove_suffix(1);
+    return line;
+}
+
+/**
+ * One line, which starts at offset in the text. Quoted fields are unquoted into the strings of unquoted.
+ */
+static void parse_line(string_view line, size_t offset, char delimiter, string (&unquoted)[field_count],
+                       PersonTable &table) {
+    string_view fields[field_count];
+    size_t pos = 0;
+    for (size_t f = 0; f < field_count; ++f) {
+        if (f > 0) {
+            if (pos >= line.size() || line[pos] != delimiter)
+                fail(offset, "expected " + to_string(field_count) + " fields");
+            ++pos;
+        }
+
+        if (pos < line.size() && line[pos] == '"') {
+            auto &field = unquoted[f];
+            field.clear();
+            for (++pos;;) {
+                auto quote = line.find('"', pos);
+                if (quote == string_view::npos)
+                    fail(offset + pos, "unterminated quote");
+                field.append(line.data() + pos, quote - pos);
+                pos = quote + 1;
+                if (pos == line.size() || line[pos] != '"')
+                    break;
+                field += '"';
+                ++pos;
+            }
+            fields[f] = field;
+        } else {
+            auto end = min(line.find(delimiter, pos), line.size());
+            fields[f] = line.substr(pos, end - pos);
+            pos = end;
+        }
+    }
+    if (pos != line.size())
+        fail(offset, "expected " + to_string(field_count) + " fields");
+
+    auto income = fields[6];
+    int annual_income = 0;
+    auto result = from_chars(income.data(), income.data() + income.size(), annual_income);
+    if (result.ec != errc{} || result.ptr != income.data() + income.size())
+        fail(offset, "bad annual income \"" + string(income) + "\"");
+
+    table.add(fields[0], fields[1], fields[2], fields[3], fields[4], fields[5], annual_income);
+}
+
+/**
+ * The lines in text[begin, end): begin is the start of a line, end the start of a line or the end of the text.
+ */
+static void parse_chunk(string_view text, size_t begin, size_t end, char delimiter, PersonTable &table) {
+    string unquoted[field_count];
+    while (begin < end) {
+        auto line_end = min(text.find('\n', begin), end);
+        auto line = without_cr(text.substr(begin, line_end - begin));
+        if (!line.empty())
+            parse_line(line, begin, delimiter, unquoted, table);
+        begin = line_end + 1;
+    }
+}
+
+PersonTable parse_people(string_view text, WorkerPool &pool, char delimiter) {
+    auto first_line = without_cr(text.substr(0, text.find('\n')));
+    if (delimiter == 0)
+        delimiter = first_line.find('\t') != string_view::npos ? '\t' : ',';
+
+    string header = field_names[0];
+    for (size_t f = 1; f < field_count; ++f)
+        header.append(1, delimiter).append(field_names[f]);
+    size_t start = first_line == header ? min(text.find('\n'), text.size() - 1) + 1 : 0;
+
+    // Chunk boundaries, each just after a line break.
+    auto size = text.size() - start;
+    auto chunks = max<size_t>(1, min(size / min_chunk, 8 * pool.size()));
+    vector<size_t> bounds{start};
+    for (size_t c = 1; c < chunks; ++c) {
+        auto line_break = text.find('\n', max(start + size / chunks * c, bounds.back()));
+        bounds.push_back(line_break == string_view::npos ? text.size() : line_break + 1);
+    }
+    bounds.push_back(text.size());
+
+    // parallel_for would rethrow whichever error happened first; keeping each chunk's reports the first in the file.
+    vector<PersonTable> tables(chunks);
+    vector<exception_ptr> errors(chunks);
+    pool.parallel_for(chunks, [&](size_t c) {
+        try {
+            parse_chunk(text, bounds[c], bounds[c + 1], delimiter, tables[c]);
+        } catch (...) {
+            errors[c] = current_exception();
+        }
+    });
+    for (const auto &error: errors)
+        if (error)
+            rethrow_exception(error);
+
+    auto people = std::move(tables[0]);
+    for (size_t c = 1; c < chunks; ++c) {
+        people.append(tables[c]);
+        tables[c] = {};
+    }
+    return people;
+}
+
+PersonTable read_people(const string &filename, WorkerPool &pool, char delimiter) {
+    int fd = ::open(filename.c_str(), O_RDONLY);
+    if (fd < 0)
+        throw system_error(errno, generic_category(), "open " + filename);
+
+    struct stat st{};
+    if (::fstat(fd, &st) < 0) {
+        auto error = errno;
+        ::close(fd);
+        throw system_error(error, generic_category(), "stat " + filename);
+    }
+
+    auto size = static_cast<size_t>(st.st_size);
+    void *data = size > 0 ? ::mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0) : nullptr;
+    auto error = errno;
+    ::close(fd);
+    if (data == MAP_FAILED)
+        throw system_error(error, generic_category(), "mmap " + filename);
+
+    struct Mapping {
+        void *data;
+        size_t size;
+
+        ~Mapping() {
+            if (data)
+                ::munmap(data, size);
+        }
+    } mapping{data, size};
+
+    try {
+        return parse_people({static_cast<const char*>(data), size}, pool, delimiter);
+    } catch (const runtime_error &e) {
+        throw runtime_error(filename + ": " + e.what());
+    }
+}
@@ -0,0 +1,28 @@
+#pragma once
+
+#include <string>
+#include <string_view>
+
+#include "PersonTable.h"
+
+class WorkerPool;
+
+/**
+ * Reads people from CSV or TSV text, one person per line:
+ *
+ *     name,street_address,post_code,city,company_name,position,annual_income
+ *
+ * A first line with these names is skipped. A delimiter of 0 means: a tab if the first line has one, a comma if
+ * not. A field may be quoted, as in "123 London Road, Flat 2", with "" for a quote inside it, but no field may
+ * hold a line break.
+ *
+ * That last rule makes every line break the end of a person. The text can then be cut into chunks at any line
+ * breaks, and the chunks parsed on the pool at the same time, each into a PersonTable of its own. The tables are
+ * then appended in file order. A malformed line throws runtime_error, giving its byte offset.
+ */
+PersonTable parse_people(string_view text, WorkerPool &pool, char delimiter = 0);
+
+/**
+ * parse_people on a file, which is mapped into memory rather than read. Errors name the file.
+ */
+PersonTable read_people(const string &filename, WorkerPool &pool, char delimiter = 0);
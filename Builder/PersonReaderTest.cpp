@@ -0,0 +1,168 @@
+#include <gtest/gtest.h>
+#include <cstdio>
+#include <fstream>
+#include <string>
+
+#include "PersonReader.h"
+#include "Lectures/worker_pool.h"
+
+/**
+ * parse_people and read_people: the CSV / TSV format, the byte offsets in their errors, and text long enough to
+ * be parsed in several chunks at once.
+ */
+static const string header = "name,street_address,post_code,city,company_name,position,annual_income\n";
+
+static string line(size_t i, char delimiter = ',') {
+    string d(1, delimiter);
+    return "Person " + to_string(i) + d + to_string(i) + " High Street" + d + "SW1 1GB" + d + "London" + d
+           + "Company " + to_string(i % 10) + d + "Engineer" + d + to_string(20'000 + i) + "\n";
+}
+
+/**
+ * The message of the runtime_error that parsing text throws, or "" if it parses.
+ */
+static string error_of(const string &text, WorkerPool &pool) {
+    try {
+        parse_people(text, pool);
+    } catch (const runtime_error &e) {
+        return e.what();
+    }
+    return "";
+}
+
+TEST(PersonReaderTests, QuotedFieldsKeepDelimitersAndDoubledQuotes) {
+    WorkerPool pool{1};
+    auto people = parse_people("\"Yagunglepuss, Felix\",\"The \"\"Old\"\" Mill, 123 London Road\",SW1 1GB,London,"
+                               "Pragmasoft,\"Consultant \"\"at large\"\"\",10000000\n", pool);
+
+    ASSERT_EQ(1, people.size());
+    EXPECT_EQ("Yagunglepuss, Felix", people.name(0));
+    EXPECT_EQ("The \"Old\" Mill, 123 London Road", people.street_address(0));
+    EXPECT_EQ("Consultant \"at large\"", people.position(0));
+    EXPECT_EQ(10'000'000, people.annual_income(0));
+}
+
+TEST(PersonReaderTests, CrlfLineEndings) {
+    WorkerPool pool{1};
+    string text = header.substr(0, header.size() - 1) + "\r\n";
+    for (size_t i = 0; i < 3; ++i) {
+        auto l = line(i);
+        text += l.substr(0, l.size() - 1) + "\r\n";
+    }
+    auto people = parse_people(text, pool);
+
+    ASSERT_EQ(3, people.size());
+    EXPECT_EQ("Person 0", people.name(0));
+    EXPECT_EQ(20'002, people.annual_income(2));
+}
+
+TEST(PersonReaderTests, HeaderIsSkippedOnlyIfPresent) {
+    WorkerPool pool{1};
+    auto with_header = parse_people(header + line(0) + line(1), pool);
+    auto without_header = parse_people(line(0) + line(1), pool);
+
+    ASSERT_EQ(2, with_header.size());
+    ASSERT_EQ(2, without_header.size());
+    EXPECT_EQ("Person 0", with_header.name(0));
+    EXPECT_EQ("Person 0", without_header.name(0));
+}
+
+TEST(PersonReaderTests, TabsAreDetected) {
+    WorkerPool pool{1};
+    string text = "name\tstreet_address\tpost_code\tcity\tcompany_name\tposition\tannual_income\n"
+                  "Felix Yagunglepuss\t123 London Road, Flat 2\tSW1 1GB\tLondon\tPragmasoft, Ltd\tConsultant\t42\n";
+    auto people = parse_people(text, pool);
+    auto headerless = parse_people(line(7, '\t'), pool);
+
+    ASSERT_EQ(1, people.size());
+    EXPECT_EQ("123 London Road, Flat 2", people.street_address(0));
+    EXPECT_EQ("Pragmasoft, Ltd", people.company_name(0));
+    EXPECT_EQ(42, people.annual_income(0));
+    ASSERT_EQ(1, headerless.size());
+    EXPECT_EQ("Person 7", headerless.name(0));
+}
+
+TEST(PersonReaderTests, ErrorsGiveTheByteOffset) {
+    WorkerPool pool{1};
+    auto good = header + line(0);
+    auto offset = to_string(good.size());
+
+    EXPECT_EQ("at byte " + offset + ": expected 7 fields", error_of(good + "Felix,London\n", pool));
+    EXPECT_EQ("at byte " + offset + ": expected 7 fields", error_of(good + "a,b,c,d,e,f,1,extra\n", pool));
+    EXPECT_EQ("at byte " + offset + ": bad annual income \"lots\"", error_of(good + "a,b,c,d,e,f,lots\n", pool));
+    EXPECT_EQ("at byte " + offset + ": bad annual income \"12x\"", error_of(good + "a,b,c,d,e,f,12x\n", pool));
+
+    // An unterminated quote is reported where its field starts, just after the quote.
+    auto quoted = good + "a,\"123 London Road,c,d,e,f,1\n";
+    EXPECT_EQ("at byte " + to_string(good.size() + 3) + ": unterminated quote", error_of(quoted, pool));
+}
+
+TEST(PersonReaderTests, ManyChunksGiveTheSamePeopleInOrder) {
+    string text = header;
+    size_t n = 0;
+    while (text.size() < 5 * (size_t{1} << 20))
+        text += line(n++);
+
+    WorkerPool one{1}, four{4};
+    auto sequential = parse_people(text, one);
+    auto parallel = parse_people(text, four);
+
+    ASSERT_EQ(n, sequential.size());
+    ASSERT_EQ(n, parallel.size());
+    for (size_t i = 0; i < n; ++i) {
+        ASSERT_EQ("Person " + to_string(i), parallel.name(i));
+        ASSERT_EQ(static_cast<int>(20'000 + i), parallel.annual_income(i));
+        ASSERT_EQ(sequential.company_name(i), parallel.company_name(i));
+    }
+    EXPECT_EQ(10, parallel.company_pool().size());
+}
+
+TEST(PersonReaderTests, ManyChunksReportTheFirstErrorInTheFile) {
+    string text = header;
+    size_t first_bad = 0, second_bad = 0;
+    for (size_t i = 0; text.size() < 5 * (size_t{1} << 20); ++i) {
+        if (i == 20'000)
+            first_bad = text.size();
+        if (i == 60'000)
+            second_bad = text.size();
+        text += i == 20'000 || i == 60'000 ? "broken\n" : line(i);
+    }
+    ASSERT_NE(0, second_bad);
+
+    WorkerPool pool{4};
+    EXPECT_EQ("at byte " + to_string(first_bad) + ": expected 7 fields", error_of(text, pool));
+}
+
+TEST(PersonReaderTests, ReadPeopleMapsTheFileAndNamesItInErrors) {
+    WorkerPool pool{2};
+    string filename = "person_reader_test.csv";
+    {
+        ofstream out{filename, ios::binary};
+        out << header << line(0) << line(1);
+    }
+    auto people = read_people(filename, pool);
+    ASSERT_EQ(2, people.size());
+    EXPECT_EQ("Person 1", people.name(1));
+
+    {
+        ofstream out{filename, ios::binary};
+        out << line(0) << "broken\n";
+    }
+    try {
+        read_people(filename, pool);
+        ADD_FAILURE() << "a malformed file was read";
+    } catch (const runtime_error &e) {
+        EXPECT_EQ(filename + ": at byte " + to_string(line(0).size()) + ": expected 7 fields", e.what());
+    }
+    remove(filename.c_str());
+
+    EXPECT_THROW(read_people(filename, pool), system_error);
+}
+
+/**
+ * Google tests: can either do this, or omit main and link to gtest_main.
+ */
+int main(int argc, char *argv[]) {
+    testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
@@ -0,0 +1,88 @@
+#include "PersonTable.h"
+#include "PersonBuilder.h"
+#include "PersonAddressBuilder.h"
+#include "PersonJobBuilder.h"
+
+StringPool::StringPool(const StringPool &other) : values(other.values) {
+    index();
+}
+
+StringPool &StringPool::operator=(const StringPool &other) {
+    if (this != &other) {
+        values = other.values;
+        index();
+    }
+    return *this;
+}
+
+void StringPool::index() {
+    ids.clear();
+    ids.reserve(values.size());
+    for (uint32_t id = 0; id < values.size(); ++id)
+        ids.emplace(values[id], id);
+}
+
+uint32_t StringPool::intern(string_view s) {
+    auto found = ids.find(s);
+    if (found != ids.end())
+        return found->second;
+
+    auto id = static_cast<uint32_t>(values.size());
+    values.emplace_back(s);
+    ids.emplace(values.back(), id);
+    return id;
+}
+
+void StringColumn::append(const StringColumn &other) {
+    auto offset = chars.size();
+    chars.append(other.chars);
+    ends.reserve(ends.size() + other.ends.size());
+    for (auto end: other.ends)
+        ends.push_back(offset + end);
+}
+
+void PersonTable::add(string_view name, string_view street_address, string_view post_code, string_view city,
+                      string_view company_name, string_view position, int annual_income) {
+    names.push_back(name);
+    street_addresses.push_back(street_address);
+    post_codes.push_back(post_code);
+    city_ids.push_back(cities.intern(city));
+    company_ids.push_back(companies.intern(company_name));
+    position_ids.push_back(positions.intern(position));
+    annual_incomes.push_back(annual_income);
+}
+
+/**
+ * Appends other's ids, translated into ids of pool: each of other's pool's strings is interned once.
+ */
+static void append_ids(vector<uint32_t> &ids, StringPool &pool, const vector<uint32_t> &other_ids,
+                       const StringPool &other_pool) {
+    vector<uint32_t> remap(other_pool.size());
+    for (uint32_t id = 0; id < other_pool.size(); ++id)
+        remap[id] = pool.intern(other_pool[id]);
+
+    ids.reserve(ids.size() + other_ids.size());
+    for (auto id: other_ids)
+        ids.push_back(remap[id]);
+}
+
+void PersonTable::append(const PersonTable &other) {
+    names.append(other.names);
+    street_addresses.append(other.street_addresses);
+    post_codes.append(other.post_codes);
+    append_ids(city_ids, cities, other.city_ids, other.cities);
+    append_ids(company_ids, companies, other.company_ids, other.companies);
+    append_ids(position_ids, positions, other.position_ids, other.positions);
+    annual_incomes.insert(annual_incomes.end(), other.annual_incomes.begin(), other.annual_incomes.end());
+}
+
+Person PersonTable::person(size_t i) const {
+    return Person::create()
+            .named(string(name(i)))
+            .lives().at(string(street_address(i)))
+                    .with_postcode(string(post_code(i)))
+                    .in(string(city(i)))
+            .works().at(string(company_name(i)))
+                    .as_a(string(position(i)))
+                    .earning(annual_income(i));
+}
@@ -0,0 +1,112 @@
+#pragma once
+
+#include <cstdint>
+#include <deque>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include "Person.h"
+
+/**
+ * Strings that repeat a lot, such as city names: each one is stored once and referred to by a small id.
+ */
+class StringPool {
+    deque<string> values;  // a deque, so that the views in ids stay valid as it grows
+    unordered_map<string_view, uint32_t> ids;
+
+    // Points ids at this pool's own values.
+    void index();
+
+public:
+    StringPool() = default;
+
+    // A copy has values of its own, so its ids are rebuilt: copied ones would still view the other pool's strings.
+    // Moving keeps the strings where they are, views and all.
+    StringPool(const StringPool &other);
+    StringPool(StringPool &&) = default;
+    StringPool &operator=(const StringPool &other);
+    StringPool &operator=(StringPool &&) = default;
+
+    uint32_t intern(string_view s);
+
+    string_view operator[](uint32_t id) const { return values[id]; }
+    size_t size() const { return values.size(); }
+};
+
+/**
+ * Strings that are mostly different, such as names: stored end to end in one buffer.
+ */
+class StringColumn {
+    string chars;
+    vector<size_t> ends;
+
+public:
+    void push_back(string_view s) {
+        chars.append(s.data(), s.size());
+        ends.push_back(chars.size());
+    }
+
+    string_view operator[](size_t i) const {
+        auto begin = i > 0 ? ends[i - 1] : 0;
+        return string_view{chars}.substr(begin, ends[i] - begin);
+    }
+
+    size_t size() const { return ends.size(); }
+
+    void append(const StringColumn &other);
+};
+
+/**
+ * PEOPLE IN BULK
+ *
+ * Person::create()...earning(...) builds one Person at a time: seven strings, each moved through the builders
+ * into an object of its own. That is fine for a person, not for tens of millions of them.
+ *
+ * PersonTable is a builder for many people at once. It keeps each field in a column of its own (a structure of
+ * arrays), so a pass over one field touches only that field. Names, addresses and post codes are stored end to
+ * end in one buffer per column. Cities, companies and positions repeat from person to person, so each distinct
+ * one is stored once and every person holds its id.
+ *
+ * Tables built separately (say, one per chunk of a file) are joined with append. A single person comes back out
+ * through the usual builder, with person(i).
+ */
+class PersonTable {
+    StringColumn names, street_addresses, post_codes;
+    StringPool cities, companies, positions;
+    vector<uint32_t> city_ids, company_ids, position_ids;
+    vector<int> annual_incomes;
+
+public:
+    size_t size() const { return annual_incomes.size(); }
+
+    void add(string_view name, string_view street_address, string_view post_code, string_view city,
+             string_view company_name, string_view position, int annual_income);
+
+    /**
+     * Adds every person of other after the ones already here.
+     */
+    void append(const PersonTable &other);
+
+    string_view name(size_t i) const { return names[i]; }
+    string_view street_address(size_t i) const { return street_addresses[i]; }
+    string_view post_code(size_t i) const { return post_codes[i]; }
+    string_view city(size_t i) const { return cities[city_ids[i]]; }
+    string_view company_name(size_t i) const { return companies[company_ids[i]]; }
+    string_view position(size_t i) const { return positions[position_ids[i]]; }
+    int annual_income(size_t i) const { return annual_incomes[i]; }
+
+    const StringPool &city_pool() const { return cities; }
+    const StringPool &company_pool() const { return companies; }
+    const StringPool &position_pool() const { return positions; }
+    const vector<uint32_t> &city_column() const { return city_ids; }
+    const vector<uint32_t> &company_column() const { return company_ids; }
+    const vector<uint32_t> &position_column() const { return position_ids; }
+    const vector<int> &annual_income_column() const { return annual_incomes; }
+
+    /**
+     * The i-th person, built with PersonBuilder.
+     */
+    Person person(size_t i) const;
+};
@@ -0,0 +1,76 @@
+#include <gtest/gtest.h>
+#include <memory>
+#include <vector>
+
+#include "PersonTable.h"
+
+/**
+ * A StringPool finds strings it already holds through views of them, so a copied table must look up its own
+ * strings and not those of the table it was copied from. Run these under AddressSanitizer to see a stale view.
+ */
+static void add(PersonTable &table, string_view name, string_view city) {
+    table.add(name, "123 London Road", "SW1 1GB", city, "Pragmasoft", "Consultant", 10'000'000);
+}
+
+TEST(PersonTableTests, CopyInternsIntoItsOwnPools) {
+    auto original = make_unique<PersonTable>();
+    add(*original, "Felix Yagunglepuss", "London");
+    add(*original, "Ada Lovelace", "Manchester");
+
+    PersonTable copy = *original;
+    original.reset();
+
+    add(copy, "Grace Hopper", "London");
+    add(copy, "Alan Turing", "Glasgow");
+
+    ASSERT_EQ(4, copy.size());
+    EXPECT_EQ(3, copy.city_pool().size());
+    EXPECT_EQ(copy.city_column()[0], copy.city_column()[2]);
+    EXPECT_EQ("London", copy.city(2));
+    EXPECT_EQ("Glasgow", copy.city(3));
+    EXPECT_EQ(1, copy.company_pool().size());
+}
+
+TEST(PersonTableTests, CopyAssignmentInternsIntoItsOwnPools) {
+    PersonTable copy;
+    add(copy, "Barbara Liskov", "York");
+    {
+        PersonTable original;
+        add(original, "Felix Yagunglepuss", "London");
+        copy = original;
+    }
+
+    add(copy, "Grace Hopper", "London");
+
+    ASSERT_EQ(2, copy.size());
+    EXPECT_EQ(1, copy.city_pool().size());
+    EXPECT_EQ(copy.city_column()[0], copy.city_column()[1]);
+    EXPECT_EQ("London", copy.city(1));
+}
+
+TEST(PersonTableTests, TablesSurviveVectorGrowth) {
+    vector<PersonTable> tables;
+    for (size_t i = 0; i < 100; ++i) {
+        tables.emplace_back();
+        add(tables.back(), "Felix Yagunglepuss", "London");
+    }
+    for (auto &table: tables)
+        add(table, "Grace Hopper", "London");
+
+    PersonTable all;
+    for (auto &table: tables)
+        all.append(table);
+
+    ASSERT_EQ(200, all.size());
+    EXPECT_EQ(1, all.city_pool().size());
+    for (auto &table: tables)
+        EXPECT_EQ(1, table.city_pool().size());
+}
+
+/**
+ * Google tests: can either do this, or omit main and link to gtest_main.
+ */
+int main(int argc, char *argv[]) {
+    testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
@@ -0,0 +1,84 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <new>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+/**
+ * A bump allocator: memory comes out of large blocks by moving a pointer, and is only given back all at once,
+ * when the arena is destroyed. Nothing in it is ever destroyed individually, so it only holds trivially
+ * destructible objects.
+ *
+ * Blocks start at first_block bytes and double up to max_block; a request bigger than that gets a block of its
+ * own. Moving an arena keeps everything allocated in it where it is.
+ */
+class Arena {
+    std::vector<std::unique_ptr<char[]>> blocks;
+    char *pos{nullptr};
+    char *end{nullptr};
+    size_t next_block;
+    size_t max_block;
+    size_t used{0};
+    size_t reserved{0};
+
+    void grow(size_t size, size_t align) {
+        auto block_size = std::max(next_block, size + align);
+        blocks.emplace_back(new char[block_size]);
+        pos = blocks.back().get();
+        end = pos + block_size;
+        reserved += block_size;
+        next_block = std::min(2 * next_block, max_block);
+    }
+
+public:
+    explicit Arena(size_t first_block = 64 * 1024, size_t max_block = 4 * 1024 * 1024)
+            : next_block(first_block), max_block(std::max(first_block, max_block)) {}
+
+    Arena(Arena &&other) noexcept
+            : blocks(std::move(other.blocks)), pos(std::exchange(other.pos, nullptr)),
+              end(std::exchange(other.end, nullptr)), next_block(other.next_block), max_block(other.max_block),
+              used(std::exchange(other.used, 0)), reserved(std::exchange(other.reserved, 0)) {}
+
+    Arena(const Arena&) = delete;
+    Arena &operator=(const Arena&) = delete;
+
+    void *allocate(size_t size, size_t align = alignof(std::max_align_t)) {
+        auto p = reinterpret_cast<uintptr_t>(pos);
+        auto aligned = (p + align - 1) & ~(uintptr_t(align) - 1);
+        if (!pos || aligned + size > reinterpret_cast<uintptr_t>(end)) {
+            grow(size, align);
+            p = reinterpret_cast<uintptr_t>(pos);
+            aligned = (p + align - 1) & ~(uintptr_t(align) - 1);
+        }
+        pos = reinterpret_cast<char*>(aligned + size);
+        used += size;
+        return reinterpret_cast<void*>(aligned);
+    }
+
+    template <typename T, typename... Args> T *make(Args&&... args) {
+        static_assert(std::is_trivially_destructible_v<T>, "the arena never runs destructors");
+        return new (allocate(sizeof(T), alignof(T))) T(std::forward<Args>(args)...);
+    }
+
+    /**
+     * Copies the characters into the arena.
+     */
+    std::string_view copy(std::string_view s) {
+        if (s.empty())
+            return {};
+        auto p = static_cast<char*>(allocate(s.size(), 1));
+        memcpy(p, s.data(), s.size());
+        return {p, s.size()};
+    }
+
+    size_t block_count() const { return blocks.size(); }
+    size_t bytes_used() const { return used; }
+    size_t bytes_reserved() const { return reserved; }
+};
@@ -0,0 +1,55 @@
+#pragma once
+
+#include <chrono>
+#include <cstdlib>
+#include <new>
+
+#include <malloc.h>
+
+/**
+ * Helpers shared by the benchmark programs.
+ */
+
+inline double seconds_since(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+/**
+ * What the program has on the heap, kept by the operator new and delete below.
+ *
+ * A program only gets those by defining COUNT_ALLOCATIONS before including this header, in one of its files:
+ * a program has one operator new, so only one file may replace it. The counters are not atomic, so they are only
+ * right in programs that allocate from one thread at a time.
+ */
+struct HeapStats {
+    size_t allocations{0};  // calls to operator new so far
+    size_t bytes{0};        // live bytes
+    size_t peak{0};         // the most live bytes at once since reset_peak()
+
+    void reset_peak() { peak = bytes; }
+};
+
+inline HeapStats heap_stats;
+
+#ifdef COUNT_ALLOCATIONS
+void *operator new(size_t size) {
+    if (auto p = malloc(size ? size : 1)) {
+        ++heap_stats.allocations;
+        heap_stats.bytes += malloc_usable_size(p);
+        if (heap_stats.bytes > heap_stats.peak)
+            heap_stats.peak = heap_stats.bytes;
+        return p;
+    }
+    throw std::bad_alloc();
+}
+
+void operator delete(void *p) noexcept {
+    if (p)
+        heap_stats.bytes -= malloc_usable_size(p);
+    free(p);
+}
+
+void operator delete(void *p, size_t) noexcept {
+    operator delete(p);
+}
+#endif
@@ -0,0 +1,42 @@
+#pragma once
+
+#include <string>
+#include <string_view>
+
+#include "lecture_07_fluent_builder.h"
+
+/**
+ * The documents the HTML benchmarks build: complete trees of count elements, whose inner elements are lists with
+ * up to fanout children and whose leaves are list items with text.
+ */
+
+/**
+ * Shares out the count - 1 elements below one element. If they all fit as its children, calls leaf() for each;
+ * otherwise calls branch(share) for each of fanout subtrees, with shares that add up to count - 1.
+ */
+template <typename Leaf, typename Branch>
+void split_bushy_tree(size_t count, size_t fanout, Leaf leaf, Branch branch) {
+    auto remaining = count - 1;
+    if (remaining <= fanout) {
+        for (size_t i = 0; i < remaining; ++i)
+            leaf();
+        return;
+    }
+    for (size_t c = 0; c < fanout; ++c) {
+        auto share = remaining / (fanout - c);
+        remaining -= share;
+        branch(share);
+    }
+}
+
+/**
+ * The tree as an HtmlElement. The leaves are numbered from item on, and their text is prefix, number, suffix.
+ */
+inline HtmlElement bushy_tree(size_t count, size_t fanout, size_t &item, std::string_view prefix = "item ",
+                              std::string_view suffix = "") {
+    auto builder = HtmlElement::create("ul");
+    split_bushy_tree(count, fanout,
+                     [&] { builder.addChild("li", std::string(prefix) + std::to_string(item++) + std::string(suffix)); },
+                     [&](size_t share) { builder.addChild(bushy_tree(share, fanout, item, prefix, suffix)); });
+    return builder;
+}
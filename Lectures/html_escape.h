@@ -0,0 +1,107 @@
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+#include <ostream>
+#include <string_view>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+#include "html_sink.h"
+
+/**
+ * HTML escaping: & < > in text, and " ' as well in attribute values, become entities.
+ *
+ * Almost all text has nothing to escape, so the work is finding the rare characters that do: 16 bytes at a time
+ * with SSE2, comparing against each special character at once. Everything before the first one found is copied
+ * as one run. The input is scanned in windows of a few KB, so each run is copied while it is still in cache.
+ */
+namespace html_escape {
+    constexpr size_t window = 4096;
+
+    constexpr std::string_view entity(char c) {
+        switch (c) {
+            case '&': return "&amp;";
+            case '<': return "&lt;";
+            case '>': return "&gt;";
+            case '"': return "&quot;";
+            default: return "&#39;";
+        }
+    }
+
+    constexpr bool needs_escape(char c, bool attribute) {
+        return c == '&' || c == '<' || c == '>' || (attribute && (c == '"' || c == '\''));
+    }
+
+    /**
+     * Index of the first character in [s, s + n) that needs escaping, or n.
+     */
+    inline size_t find_scalar(const char *s, size_t n, bool attribute) {
+        for (size_t i = 0; i < n; ++i)
+            if (needs_escape(s[i], attribute))
+                return i;
+        return n;
+    }
+
+#if defined(__SSE2__)
+    inline size_t find_sse2(const char *s, size_t n, bool attribute) {
+        const auto amp = _mm_set1_epi8('&'), lt = _mm_set1_epi8('<'), gt = _mm_set1_epi8('>');
+        const auto quot = _mm_set1_epi8(attribute ? '"' : '&');
+        const auto apos = _mm_set1_epi8(attribute ? '\'' : '&');
+
+        size_t i = 0;
+        for (; i + 16 <= n; i += 16) {
+            auto v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(s + i));
+            auto hits = _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(v, amp), _mm_cmpeq_epi8(v, lt)),
+                                     _mm_or_si128(_mm_cmpeq_epi8(v, gt),
+                                                  _mm_or_si128(_mm_cmpeq_epi8(v, quot), _mm_cmpeq_epi8(v, apos))));
+            if (auto mask = _mm_movemask_epi8(hits))
+                return i + __builtin_ctz(mask);
+        }
+        return i + find_scalar(s + i, n - i, attribute);
+    }
+#endif
+
+    inline size_t find(const char *s, size_t n, bool attribute) {
+#if defined(__SSE2__)
+        return find_sse2(s, n, attribute);
+#else
+        return find_scalar(s, n, attribute);
+#endif
+    }
+
+    /**
+     * Calls write(data, size) with the escaped text: runs of s that need no escaping, and entities.
+     */
+    template <typename Write> void escape(std::string_view s, bool attribute, Write &&write) {
+        const char *p = s.data();
+        size_t left = s.size();
+        while (left > 0) {
+            auto n = left < window ? left : window;
+            auto safe = find(p, n, attribute);
+            if (safe > 0)
+                write(p, safe);
+            if (safe < n) {
+                auto e = entity(p[safe]);
+                write(e.data(), e.size());
+                ++safe;
+            }
+            p += safe;
+            left -= safe;
+        }
+    }
+}
+
+inline void escape_html(HtmlSink &sink, std::string_view s, bool attribute = false) {
+    html_escape::escape(s, attribute, [&sink](const char *data, size_t size) {
+        sink.append(std::string_view{data, size});
+    });
+}
+
+inline void escape_html(std::ostream &os, std::string_view s, bool attribute = false) {
+    html_escape::escape(s, attribute, [&os](const char *data, size_t size) {
+        os.write(data, static_cast<std::streamsize>(size));
+    });
+}
@@ -0,0 +1,197 @@
+#pragma once
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <ostream>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <vector>
+
+#include <unistd.h>
+
+/**
+ * Somewhere to render HTML into.
+ *
+ * Renderers append straight into the sink's current region of memory; only when it is full does the sink do
+ * anything else (grow, or hand the bytes on to a stream or a file descriptor). Indentation comes from one cached
+ * run of spaces, so indenting never builds a string.
+ */
+class HtmlSink {
+    char *pos{nullptr};
+    char *end{nullptr};
+    std::string indentation;
+
+protected:
+    void set_region(char *begin, char *region_end) {
+        pos = begin;
+        end = region_end;
+    }
+
+    char *position() const { return pos; }
+
+    /**
+     * Called when size bytes do not fit in the current region: the sink must take them somehow.
+     */
+    virtual void overflow(const char *data, size_t size) = 0;
+
+public:
+    virtual ~HtmlSink() = default;
+
+    HtmlSink &append(std::string_view s) {
+        if (static_cast<size_t>(end - pos) >= s.size()) {
+            memcpy(pos, s.data(), s.size());
+            pos += s.size();
+        } else {
+            overflow(s.data(), s.size());
+        }
+        return *this;
+    }
+
+    HtmlSink &append(char c) {
+        if (pos != end)
+            *pos++ = c;
+        else
+            overflow(&c, 1);
+        return *this;
+    }
+
+    HtmlSink &spaces(size_t count) {
+        if (indentation.size() < count)
+            indentation.assign(std::max(count, 2 * indentation.size()), ' ');
+        return append(std::string_view{indentation}.substr(0, count));
+    }
+
+    /**
+     * Pushes buffered bytes on to their destination, if the sink has one.
+     */
+    virtual void flush() {}
+};
+
+/**
+ * Renders into a growable in-memory buffer.
+ */
+class BufferSink : public HtmlSink {
+    std::string buffer;
+
+protected:
+    void overflow(const char *data, size_t size) override {
+        auto used = position() ? size_t(position() - &buffer[0]) : 0;
+        buffer.resize(std::max(2 * buffer.size(), used + size));
+        memcpy(&buffer[used], data, size);
+        set_region(&buffer[used + size], &buffer[0] + buffer.size());
+    }
+
+public:
+    explicit BufferSink(size_t capacity = 4096) : buffer(std::max<size_t>(capacity, 1), '\0') {
+        set_region(&buffer[0], &buffer[0] + buffer.size());
+    }
+
+    std::string_view view() const {
+        return {buffer.data(), position() ? size_t(position() - buffer.data()) : 0};
+    }
+
+    /**
+     * Moves the rendered bytes out; the sink is empty afterwards. The string is the sink's own buffer, so nothing
+     * is copied.
+     */
+    std::string take() {
+        buffer.resize(view().size());
+        auto result = std::move(buffer);
+        buffer.clear();
+        set_region(nullptr, nullptr);
+        return result;
+    }
+};
+
+/**
+ * Collects bytes in a fixed buffer and writes them out in large chunks when it fills up.
+ */
+class FlushingSink : public HtmlSink {
+    std::vector<char> buffer;
+
+protected:
+    virtual void write(const char *data, size_t size) = 0;
+
+    void overflow(const char *data, size_t size) override {
+        flush();
+        if (size >= buffer.size()) {
+            write(data, size);
+        } else {
+            memcpy(buffer.data(), data, size);
+            set_region(buffer.data() + size, buffer.data() + buffer.size());
+        }
+    }
+
+public:
+    explicit FlushingSink(size_t buffer_size) : buffer(std::max<size_t>(buffer_size, 1)) {
+        set_region(buffer.data(), buffer.data() + buffer.size());
+    }
+
+    void flush() override {
+        auto used = size_t(position() - buffer.data());
+        set_region(buffer.data(), buffer.data() + buffer.size());
+        if (used > 0)
+            write(buffer.data(), used);
+    }
+};
+
+class OstreamSink : public FlushingSink {
+    std::ostream &out;
+
+protected:
+    void write(const char *data, size_t size) override {
+        out.write(data, static_cast<std::streamsize>(size));
+    }
+
+public:
+    explicit OstreamSink(std::ostream &out, size_t buffer_size = 64 * 1024) : FlushingSink(buffer_size), out(out) {}
+
+    ~OstreamSink() override {
+        flush();
+    }
+};
+
+/**
+ * Writes to a file descriptor, which it does not own. Write errors throw std::system_error from flush();
+ * call it explicitly to see them, since the destructor swallows them.
+ */
+class FdSink : public FlushingSink {
+    int fd;
+
+protected:
+    void write(const char *data, size_t size) override {
+        while (size > 0) {
+            auto n = ::write(fd, data, size);
+            if (n < 0) {
+                if (errno == EINTR)
+                    continue;
+                throw std::system_error(errno, std::generic_category(), "write");
+            }
+            data += n;
+            size -= static_cast<size_t>(n);
+        }
+    }
+
+public:
+    explicit FdSink(int fd, size_t buffer_size = 64 * 1024) : FlushingSink(buffer_size), fd(fd) {}
+
+    ~FdSink() override {
+        try {
+            flush();
+        } catch (...) {
+            // Nothing sensible to do with a write error while destroying.
+        }
+    }
+};
+
+/**
+ * How to render a tree of Node piece by piece, for renderers that split the work (see parallel_render.h).
+ * A specialization provides
+ *     static const vector<Node> &children(const Node &node);
+ *     static void open(const Node &node, HtmlSink &sink, int depth);    // everything before the children
+ *     static void close(const Node &node, HtmlSink &sink, int depth);   // everything after them
+ * such that open, the children at depth + 1, then close write exactly what the node's own renderer does.
+ */
+template <typename Node> struct RenderTraits;
@@ -0,0 +1,106 @@
+#include <algorithm>
+
+#include "lecture_01_async_persistence.h"
+#include "lecture_01_journal_writer.h"
+
+using latency_clock = chrono::steady_clock;
+
+void report(const string &label, vector<double> latencies) {
+    sort(latencies.begin(), latencies.end());
+    auto at = [&latencies](double q) {
+        return latencies[min(latencies.size() - 1, static_cast<size_t>(q * latencies.size()))];
+    };
+    cout << "  " << label << " (" << latencies.size() << " saves, us):"
+         << " p50 " << at(0.50) << ", p90 " << at(0.90) << ", p99 " << at(0.99)
+         << ", p99.9 " << at(0.999) << ", max " << latencies.back() << endl;
+}
+
+double micros_since(latency_clock::time_point start) {
+    return chrono::duration<double, micro>(latency_clock::now() - start).count();
+}
+
+/**
+ * Latency of add_entry followed by a save, per entry:
+ * - PersistenceManager::save, rewriting the whole file each time;
+ * - a JournalWriter committed (fsync) after every entry, which is what a synchronous durable save costs;
+ * - AsyncJournalPersistence, both as seen by the caller and until the writer acknowledged durability.
+ * Usage: lecture_01_async_persistence [entries for save] [entries for the others]
+ */
+int main(int argc, char *argv[]) {
+    size_t save_entries = argc > 1 ? stoul(argv[1]) : 1'000;
+    size_t entries = argc > 2 ? stoul(argv[2]) : 20'000;
+
+    vector<double> latencies;
+    {
+        Journal journal{"Dear diary"};
+        for (size_t i = 0; i < save_entries; ++i) {
+            auto start = latency_clock::now();
+            journal.add_entry("Entry " + to_string(i));
+            PersistenceManager::save(journal, "diary_sync.txt");
+            latencies.push_back(micros_since(start));
+        }
+        report("PersistenceManager::save     ", latencies);
+    }
+
+    latencies.clear();
+    {
+        Journal journal{"Dear diary"};
+        JournalWriter writer{journal, "diary_writer.txt"};
+        for (size_t i = 0; i < entries; ++i) {
+            auto start = latency_clock::now();
+            journal.add_entry("Entry " + to_string(i));
+            writer.append(journal);
+            writer.commit();
+            latencies.push_back(micros_since(start));
+        }
+        report("JournalWriter, fsync per save", latencies);
+    }
+
+    latencies.clear();
+    vector<double> durable(entries);
+    AsyncPersistence::Stats stats;
+    {
+        AsyncPersistence service;
+        Journal journal{"Dear diary"};
+        AsyncJournalPersistence persistence{service, journal, "diary_async.txt"};
+        for (size_t i = 0; i < entries; ++i) {
+            auto start = latency_clock::now();
+            journal.add_entry("Entry " + to_string(i));
+            persistence.save(journal, [&durable, i, start](error_code ec) {
+                durable[i] = ec ? -1.0 : micros_since(start);
+            });
+            latencies.push_back(micros_since(start));
+        }
+        service.shutdown();
+        stats = service.stats();
+    }
+    report("AsyncPersistence, caller     ", latencies);
+    report("AsyncPersistence, durable    ", durable);
+    cout << "  writer: " << stats.requests << " requests in " << stats.batches << " batches, "
+         << stats.fsyncs << " fsyncs, " << stats.full_waits << " waits on a full queue" << endl;
+
+    if (any_of(durable.begin(), durable.end(), [](double d) { return d < 0; })) {
+        cerr << "Some saves failed" << endl;
+        return 1;
+    }
+
+    // A bad target is the caller's error, and a throwing callback must not stop the writer.
+    {
+        AsyncPersistence service;
+        auto target = service.open("diary_async.txt");
+        bool refused = false;
+        try {
+            service.append(target + 1, "lost\n");
+        } catch (const out_of_range &) {
+            refused = true;
+        }
+        service.append(target, "first\n", [](error_code) { throw runtime_error("callback failed"); });
+        auto second = service.append(target, "second\n");
+        if (!refused || second.wait_for(chrono::seconds(10)) != future_status::ready) {
+            cerr << "A bad target or a throwing callback broke AsyncPersistence" << endl;
+            return 1;
+        }
+    }
+
+    return 0;
+}
@@ -0,0 +1,392 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <system_error>
+#include <thread>
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include "lecture_01_single_responsibility_principle.h"
+
+/**
+ * ASYNCHRONOUS PERSISTENCE
+ *
+ * PersistenceManager::save does its disk I/O on the caller's thread. AsyncPersistence moves it to one dedicated
+ * writer thread:
+ *
+ * - Callers hand over bytes for an append-only target file through a bounded, lock-free multi-producer queue.
+ * - The writer takes whatever is queued, writes it, fsyncs every file it touched once for the whole batch
+ *   (group commit), and only then acknowledges each request, through a future or a callback.
+ * - When the queue is full, append() waits for room (backpressure) and try_append() returns false.
+ * - shutdown() (or the destructor) stops new submissions, lets the writer drain and commit everything already
+ *   queued, and joins it. Call it once the producers are done: a submission racing with it may be dropped.
+ * - A target that open() did not return is refused with out_of_range when it is submitted. Callbacks should not
+ *   throw: one that does cannot be reported to anyone, so the writer drops the exception and carries on.
+ *
+ * Anything that can be turned into bytes can be persisted this way; AsyncJournalPersistence does it for journals.
+ */
+
+/**
+ * Bounded multi-producer / multi-consumer queue (Dmitry Vyukov's design). Each cell carries a sequence number that
+ * tells producers and consumers whose turn it is, so neither side ever takes a lock.
+ */
+template <typename T> class BoundedQueue {
+    struct Cell {
+        std::atomic<size_t> sequence;
+        T value;
+    };
+
+    std::unique_ptr<Cell[]> cells;
+    size_t mask;
+    alignas(64) std::atomic<size_t> enqueue_pos{0};
+    alignas(64) std::atomic<size_t> dequeue_pos{0};
+
+public:
+    /**
+     * capacity is rounded up to a power of two.
+     */
+    explicit BoundedQueue(size_t capacity) {
+        size_t size = 2;
+        while (size < capacity)
+            size *= 2;
+        cells.reset(new Cell[size]);
+        mask = size - 1;
+        for (size_t i = 0; i < size; ++i)
+            cells[i].sequence.store(i, std::memory_order_relaxed);
+    }
+
+    /**
+     * Leaves value untouched and returns false if the queue is full.
+     */
+    bool try_push(T &value) {
+        size_t pos = enqueue_pos.load(std::memory_order_relaxed);
+        for (;;) {
+            Cell &cell = cells[pos & mask];
+            auto seq = cell.sequence.load(std::memory_order_acquire);
+            auto diff = static_cast<intptr_t>(seq) - static_cast<intptr_t>(pos);
+            if (diff == 0) {
+                if (enqueue_pos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                    cell.value = std::move(value);
+                    cell.sequence.store(pos + 1, std::memory_order_release);
+                    return true;
+                }
+            } else if (diff < 0) {
+                return false;
+            } else {
+                pos = enqueue_pos.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    bool try_pop(T &out) {
+        size_t pos = dequeue_pos.load(std::memory_order_relaxed);
+        for (;;) {
+            Cell &cell = cells[pos & mask];
+            auto seq = cell.sequence.load(std::memory_order_acquire);
+            auto diff = static_cast<intptr_t>(seq) - static_cast<intptr_t>(pos + 1);
+            if (diff == 0) {
+                if (dequeue_pos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                    out = std::move(cell.value);
+                    cell.sequence.store(pos + mask + 1, std::memory_order_release);
+                    return true;
+                }
+            } else if (diff < 0) {
+                return false;
+            } else {
+                pos = dequeue_pos.load(std::memory_order_relaxed);
+            }
+        }
+    }
+};
+
+class AsyncPersistence {
+public:
+    using Target = size_t;
+    using Callback = std::function<void(std::error_code)>;
+
+    struct Stats {
+        size_t requests{0};
+        size_t batches{0};
+        size_t fsyncs{0};
+        size_t full_waits{0};
+    };
+
+private:
+    struct Request {
+        Target target{0};
+        string bytes;
+        Callback done;
+    };
+
+    struct File {
+        int fd;
+        string filename;
+        string pending;
+        std::error_code error;
+
+        File(int fd, string filename) : fd(fd), filename(std::move(filename)) {}
+    };
+
+    BoundedQueue<Request> queue;
+    bool fsync_enabled;
+
+    // Files are only added under files_mutex; the writer looks them up under it too.
+    std::mutex files_mutex;
+    vector<unique_ptr<File>> files;
+
+    std::atomic<bool> accepting{true};
+    std::atomic<bool> stopping{false};
+    std::atomic<bool> writer_sleeping{false};
+    std::mutex wake_mutex;
+    std::condition_variable wake;
+
+    std::atomic<size_t> full_waits{0};
+    size_t batches{0}, fsyncs{0}, requests{0};
+    mutable std::mutex stats_mutex;
+
+    std::thread writer;
+
+    File &file(Target t) {
+        std::lock_guard<std::mutex> lock{files_mutex};
+        return *files[t];
+    }
+
+    void check_target(Target t) {
+        std::lock_guard<std::mutex> lock{files_mutex};
+        if (t >= files.size())
+            throw std::out_of_range("AsyncPersistence: no target " + to_string(t));
+    }
+
+    static std::error_code write_all(int fd, const string &bytes) {
+        const char *data = bytes.data();
+        size_t left = bytes.size();
+        while (left > 0) {
+            auto n = ::write(fd, data, left);
+            if (n < 0) {
+                if (errno == EINTR)
+                    continue;
+                return {errno, std::generic_category()};
+            }
+            data += n;
+            left -= static_cast<size_t>(n);
+        }
+        return {};
+    }
+
+    void run() {
+        vector<Request> batch;
+        vector<std::error_code> results;
+        Request request;
+
+        for (;;) {
+            while (batch.size() < 4096 && queue.try_pop(request))
+                batch.push_back(std::move(request));
+
+            if (batch.empty()) {
+                if (stopping.load())
+                    return;
+                // Nothing to do: sleep until a producer wakes us, re-checking periodically in case a wakeup raced.
+                std::unique_lock<std::mutex> lock{wake_mutex};
+                writer_sleeping = true;
+                if (queue.try_pop(request)) {
+                    writer_sleeping = false;
+                    batch.push_back(std::move(request));
+                    continue;
+                }
+                wake.wait_for(lock, std::chrono::milliseconds(1));
+                writer_sleeping = false;
+                continue;
+            }
+
+            // Coalesce the batch into one buffer per file, so each file costs one write and one fsync.
+            vector<File*> touched;
+            for (auto &r: batch) {
+                auto &f = file(r.target);
+                if (f.pending.empty())
+                    touched.push_back(&f);
+                f.pending += r.bytes;
+            }
+
+            size_t synced = 0;
+            for (auto f: touched) {
+                f->error = write_all(f->fd, f->pending);
+                f->pending.clear();
+                if (fsync_enabled && !f->error) {
+                    ++synced;
+                    if (::fsync(f->fd) != 0)
+                        f->error = {errno, std::generic_category()};
+                }
+            }
+
+            results.clear();
+            for (auto &r: batch)
+                results.push_back(file(r.target).error);
+
+            for (size_t i = 0; i < batch.size(); ++i) {
+                if (!batch[i].done)
+                    continue;
+                try {
+                    batch[i].done(results[i]);
+                } catch (...) {
+                    // Nobody to report it to; the other requests still get their acknowledgements.
+                }
+            }
+
+            {
+                std::lock_guard<std::mutex> lock{stats_mutex};
+                requests += batch.size();
+                ++batches;
+                fsyncs += synced;
+            }
+            batch.clear();
+        }
+    }
+
+    void wake_writer() {
+        if (writer_sleeping.load()) {
+            std::lock_guard<std::mutex> lock{wake_mutex};
+            wake.notify_one();
+        }
+    }
+
+public:
+    explicit AsyncPersistence(size_t queue_capacity = 4096, bool fsync = true)
+            : queue(queue_capacity), fsync_enabled(fsync), writer([this] { run(); }) {}
+
+    ~AsyncPersistence() {
+        shutdown();
+        for (auto &f: files)
+            ::close(f->fd);
+    }
+
+    AsyncPersistence(const AsyncPersistence&) = delete;
+    AsyncPersistence &operator=(const AsyncPersistence&) = delete;
+
+    /**
+     * Creates (or truncates) an append-only file and returns the handle to submit writes to it with.
+     */
+    Target open(const string &filename) {
+        int fd = ::open(filename.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_APPEND, 0644);
+        if (fd < 0)
+            throw std::system_error(errno, std::generic_category(), "open " + filename);
+        std::lock_guard<std::mutex> lock{files_mutex};
+        files.push_back(make_unique<File>(fd, filename));
+        return files.size() - 1;
+    }
+
+    /**
+     * Queues bytes for target without waiting. done is called on the writer thread once they are durable.
+     * Returns false, leaving bytes untouched, if the queue is full.
+     */
+    bool try_append(Target target, string &bytes, Callback done = {}) {
+        if (!accepting.load())
+            throw std::logic_error("AsyncPersistence: append after shutdown");
+        check_target(target);
+        Request request{target, std::move(bytes), std::move(done)};
+        if (!queue.try_push(request)) {
+            bytes = std::move(request.bytes);
+            return false;
+        }
+        wake_writer();
+        return true;
+    }
+
+    /**
+     * Queues bytes for target, waiting for room if the queue is full.
+     */
+    void append(Target target, string bytes, Callback done) {
+        if (!accepting.load())
+            throw std::logic_error("AsyncPersistence: append after shutdown");
+        check_target(target);
+        Request request{target, std::move(bytes), std::move(done)};
+        if (queue.try_push(request)) {
+            wake_writer();
+            return;
+        }
+
+        full_waits.fetch_add(1, std::memory_order_relaxed);
+        for (int spins = 0; !queue.try_push(request); ++spins) {
+            wake_writer();
+            if (spins < 64)
+                std::this_thread::yield();
+            else
+                std::this_thread::sleep_for(std::chrono::microseconds(50));
+        }
+        wake_writer();
+    }
+
+    /**
+     * Queues bytes for target; the future is ready once they are durable, or holds the I/O error.
+     */
+    std::future<void> append(Target target, string bytes) {
+        auto promise = std::make_shared<std::promise<void>>();
+        auto future = promise->get_future();
+        append(target, std::move(bytes), [promise](std::error_code ec) {
+            if (ec)
+                promise->set_exception(std::make_exception_ptr(std::system_error(ec)));
+            else
+                promise->set_value();
+        });
+        return future;
+    }
+
+    /**
+     * Stops accepting writes, waits until everything queued is written and committed, and stops the writer.
+     */
+    void shutdown() {
+        if (!accepting.exchange(false))
+            return;
+        stopping = true;
+        {
+            std::lock_guard<std::mutex> lock{wake_mutex};
+            wake.notify_one();
+        }
+        writer.join();
+    }
+
+    Stats stats() const {
+        std::lock_guard<std::mutex> lock{stats_mutex};
+        return {requests, batches, fsyncs, full_waits.load()};
+    }
+};
+
+/**
+ * Persists a journal through AsyncPersistence: each save() queues the entries added since the previous save,
+ * in the same text format as PersistenceManager::save.
+ */
+class AsyncJournalPersistence {
+    AsyncPersistence &service;
+    AsyncPersistence::Target target;
+    size_t persisted{0};
+
+    string take_new_entries(const Journal &journal) {
+        string bytes;
+        for (; persisted < journal.entries.size(); ++persisted) {
+            bytes += journal.entries[persisted];
+            bytes += '\n';
+        }
+        return bytes;
+    }
+
+public:
+    AsyncJournalPersistence(AsyncPersistence &service, const Journal &journal, const string &filename)
+            : service(service), target(service.open(filename)) {
+        service.append(target, journal.title + "\n" + take_new_entries(journal), {});
+    }
+
+    std::future<void> save(const Journal &journal) {
+        return service.append(target, take_new_entries(journal));
+    }
+
+    void save(const Journal &journal, AsyncPersistence::Callback done) {
+        service.append(target, take_new_entries(journal), std::move(done));
+    }
+};
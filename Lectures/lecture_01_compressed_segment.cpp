@@ -0,0 +1,123 @@
+#include <chrono>
+#include <numeric>
+#include <random>
+
+#include "lecture_01_compressed_segment.h"
+#include "bench_util.h"
+
+/**
+ * Writes the same journal as a plain segment and as a compressed segment, then compares file size, write
+ * throughput, random entry reads and a full sequential replay.
+ * Usage: lecture_01_compressed_segment [entries] [block bytes]
+ */
+int main(int argc, char *argv[]) {
+    size_t n = max<size_t>(1, argc > 1 ? stoull(argv[1]) : 1'000'000);
+    size_t block_bytes = argc > 2 ? stoull(argv[2]) : 16 * 1024;
+
+    const vector<string> moods{"happy", "tired", "hungry", "curious", "sleepy"};
+    const vector<string> foods{"a bug", "two bugs", "a beetle", "some ants", "a very large moth"};
+    mt19937_64 rng{42};
+    Journal journal{"Dear diary"};
+    for (size_t i = 0; i < n; ++i)
+        journal.add_entry("Today I felt " + moods[rng() % moods.size()] + " and ate " + foods[rng() % foods.size()]
+                          + " at " + to_string(rng() % 24) + ":" + to_string(rng() % 60));
+
+    size_t raw_bytes = 0;
+    for (auto &e: journal.entries)
+        raw_bytes += e.size();
+
+    auto start = chrono::steady_clock::now();
+    JournalSegmentWriter::write(journal, "diary.jseg");
+    auto plain_write = seconds_since(start);
+
+    start = chrono::steady_clock::now();
+    CompressedSegmentWriter::write(journal, "diary.jscz", block_bytes);
+    auto compressed_write = seconds_since(start);
+
+    JournalSegment plain{"diary.jseg"};
+    CompressedSegment compressed{"diary.jscz"};
+
+    size_t lookups = 200'000;
+    vector<size_t> picks(lookups);
+    for (auto &p: picks)
+        p = rng() % n;
+
+    auto time_reads = [&](auto &segment, auto &indices) {
+        size_t total = 0;
+        auto start = chrono::steady_clock::now();
+        for (auto i: indices)
+            total += segment[i].size();
+        return make_pair(seconds_since(start), total);
+    };
+
+    vector<size_t> all(n);
+    iota(all.begin(), all.end(), 0);
+    auto plain_random = time_reads(plain, picks);
+    auto compressed_random = time_reads(compressed, picks);
+    auto plain_replay = time_reads(plain, all);
+    auto compressed_replay = time_reads(compressed, all);
+
+    auto mb = [](double bytes) { return bytes / (1 << 20); };
+    auto plain_size = static_cast<double>(ifstream("diary.jseg", ios::ate | ios::binary).tellg());
+    cout << n << " entries, " << mb(raw_bytes) << " MB of entry text, " << block_bytes << "-byte blocks" << endl
+         << "  plain segment:      " << mb(plain_size)
+         << " MB, written at " << mb(raw_bytes) / plain_write << " MB/s" << endl
+         << "  compressed segment: " << mb(compressed.file_size()) << " MB, written at "
+         << mb(raw_bytes) / compressed_write << " MB/s" << endl
+         << "  compression ratio:  " << static_cast<double>(raw_bytes) / compressed.file_size() << endl
+         << "  random reads:       plain " << lookups / plain_random.first / 1e6 << " M/s, compressed "
+         << lookups / compressed_random.first / 1e6 << " M/s" << endl
+         << "  sequential replay:  plain " << mb(plain_replay.second) / plain_replay.first << " MB/s, compressed "
+         << mb(compressed_replay.second) / compressed_replay.first << " MB/s" << endl;
+
+    if (compressed.title() != journal.title || compressed.size() != journal.entries.size()
+        || plain_random.second != compressed_random.second) {
+        cerr << "Compressed segment does not match the journal" << endl;
+        return 1;
+    }
+    for (size_t i = 0; i < n; ++i) {
+        if (compressed[i] != journal.entries[i]) {
+            cerr << "Entry " << i << " does not match" << endl;
+            return 1;
+        }
+    }
+
+    // Damaged copies of a small segment must throw, when opened or when their block is read, not read or write
+    // out of bounds.
+    Journal small_journal{"Dear diary"};
+    for (auto entry: {"I ate a bug", "I cried today", "I ate another bug", "I ate a bug again, I ate a bug again"})
+        small_journal.add_entry(entry);
+    CompressedSegmentWriter::write(small_journal, "diary_small.jscz", 32);
+    ifstream small_file{"diary_small.jscz", ios::binary};
+    string small{istreambuf_iterator<char>(small_file), {}};
+    auto refused = [&](size_t offset, auto value) {
+        auto damaged = small;
+        memcpy(&damaged[offset], &value, sizeof(value));
+        ofstream{"diary_bad.jscz", ios::binary} << damaged;
+        try {
+            CompressedSegment bad{"diary_bad.jscz"};
+            for (size_t i = 0; i < bad.size(); ++i)
+                bad[i];
+        } catch (const runtime_error &) {
+            return true;
+        }
+        return false;
+    };
+    uint64_t index_offset, blocks;
+    memcpy(&blocks, &small[16], sizeof(blocks));
+    memcpy(&index_offset, &small[24], sizeof(index_offset));
+    auto block = [&](size_t b, size_t field) {
+        return index_offset + b * sizeof(compressed_segment::BlockInfo) + field;
+    };
+    auto first_block = compressed_segment::header_size + small_journal.title.size();
+    if (blocks < 2 || !refused(8, uint64_t{0}) || !refused(16, ~uint64_t{0}) || !refused(block(0, 0), index_offset)
+        || !refused(block(0, 8), ~uint32_t{0}) || !refused(block(0, 8), uint32_t{1})
+        || !refused(block(0, 12), uint32_t{1} << 20) || !refused(block(0, 16), uint64_t{1})
+        || !refused(block(1, 16), uint64_t{0}) || !refused(block(1, 16), small_journal.entries.size())
+        || !refused(first_block, ~uint32_t{0})) {
+        cerr << "A damaged compressed segment was read" << endl;
+        return 1;
+    }
+
+    return 0;
+}
@@ -0,0 +1,487 @@
+#pragma once
+
+#include <algorithm>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+
+#include "lecture_01_journal_segment.h"
+
+/**
+ * COMPRESSED JOURNAL SEGMENTS
+ *
+ * Journals are very repetitive text, and persisting them is limited by disk bandwidth. A compressed segment
+ * stores the entries in independently compressed blocks of about block_bytes each:
+ *
+ *     header   magic "JSCZ", version, entry count, block count, offset of the block index, title length, title
+ *     blocks   compressed blocks, back to back
+ *     index    per block: file offset, compressed size, raw size, number of its first entry (8-byte aligned)
+ *
+ * Uncompressed, a block is: entry count (uint32), entry count + 1 uint32 offsets, then the entry bytes.
+ *
+ * The compressor is a small self-contained LZ77: a block is a sequence of
+ *     varint literal count, the literals, varint (match length - 4), varint match distance
+ * ending with a literal run that reaches the block's raw size. Matches are found through a hash table of 4-byte
+ * prefixes, and may overlap their own output.
+ *
+ * A segment is checked as it is read, as a JournalSegment is. Opening it checks the header and the block index
+ * (one pass over the blocks, not the entries); decompressing a block checks every literal run and match against
+ * both the compressed and the raw size, and then the block's entry offsets. A damaged file throws runtime_error
+ * instead of reading or writing out of bounds.
+ *
+ * CompressedSegmentWriter hands full blocks to a background thread, which compresses and writes them in order
+ * while the caller keeps adding entries. CompressedSegment reads one entry by decompressing only its block, and
+ * keeps the last decompressed block so neighbouring entries are cheap.
+ */
+namespace compressed_segment {
+    constexpr char magic[4] = {'J', 'S', 'C', 'Z'};
+    constexpr uint32_t version = 1;
+
+    // magic, version, entry count, block count, index offset, title length
+    constexpr size_t header_size = 4 + 4 + 8 + 8 + 8 + 4;
+
+    struct BlockInfo {
+        uint64_t offset;
+        uint32_t compressed_size;
+        uint32_t raw_size;
+        uint64_t first_entry;
+    };
+
+    inline void put_varint(string &out, uint32_t value) {
+        while (value >= 0x80) {
+            out += static_cast<char>(value | 0x80);
+            value >>= 7;
+        }
+        out += static_cast<char>(value);
+    }
+
+    [[noreturn]] inline void corrupt_block(const char *what) {
+        throw runtime_error(string("corrupt compressed block (") + what + ")");
+    }
+
+    inline uint32_t get_varint(const char *&in, const char *end) {
+        uint32_t value = 0;
+        for (int shift = 0;; shift += 7) {
+            if (in == end || shift > 28)
+                corrupt_block("truncated number");
+            auto byte = static_cast<uint8_t>(*in++);
+            value |= static_cast<uint32_t>(byte & 0x7f) << shift;
+            if (!(byte & 0x80))
+                return value;
+        }
+    }
+
+    inline uint32_t read32(const char *p) {
+        uint32_t v;
+        memcpy(&v, p, sizeof(v));
+        return v;
+    }
+
+    inline void compress(string_view raw, string &out) {
+        constexpr int hash_bits = 14;
+        constexpr size_t min_match = 4;
+        constexpr size_t max_distance = 65535;
+        vector<uint32_t> table(size_t{1} << hash_bits, 0);
+        auto hash = [](uint32_t v) { return (v * 2654435761u) >> (32 - hash_bits); };
+
+        out.clear();
+        const char *data = raw.data();
+        size_t n = raw.size(), anchor = 0, i = 0;
+        while (i + min_match <= n) {
+            auto h = hash(read32(data + i));
+            size_t candidate = table[h];
+            table[h] = static_cast<uint32_t>(i + 1);  // 0 means empty
+
+            if (candidate-- == 0 || i - candidate > max_distance || read32(data + candidate) != read32(data + i)) {
+                ++i;
+                continue;
+            }
+
+            size_t length = min_match;
+            while (i + length < n && data[candidate + length] == data[i + length])
+                ++length;
+
+            put_varint(out, static_cast<uint32_t>(i - anchor));
+            out.append(data + anchor, i - anchor);
+            put_varint(out, static_cast<uint32_t>(length - min_match));
+            put_varint(out, static_cast<uint32_t>(i - candidate));
+
+            // Index a few positions inside the match too, so later repeats of its text are found.
+            for (size_t k = i + 1; k + min_match <= n && k < i + length; k += 3)
+                table[hash(read32(data + k))] = static_cast<uint32_t>(k + 1);
+
+            i += length;
+            anchor = i;
+        }
+        put_varint(out, static_cast<uint32_t>(n - anchor));
+        out.append(data + anchor, n - anchor);
+    }
+
+    /**
+     * Decompresses the compressed_size bytes at in, which must come to exactly raw_size bytes.
+     */
+    inline void decompress(const char *in, size_t compressed_size, size_t raw_size, string &out) {
+        out.resize(raw_size);
+        char *dst = &out[0];
+        const char *in_end = in + compressed_size;
+        size_t pos = 0;
+        for (;;) {
+            size_t literals = get_varint(in, in_end);
+            if (literals > raw_size - pos || literals > static_cast<size_t>(in_end - in))
+                corrupt_block("literals out of bounds");
+            memcpy(dst + pos, in, literals);
+            in += literals;
+            pos += literals;
+            if (pos == raw_size)
+                return;
+
+            size_t length = size_t{get_varint(in, in_end)} + 4;
+            size_t distance = get_varint(in, in_end);
+            if (distance == 0 || distance > pos || length > raw_size - pos)
+                corrupt_block("match out of bounds");
+            if (distance >= length) {
+                memcpy(dst + pos, dst + pos - distance, length);
+                pos += length;
+            } else {
+                // The match overlaps the bytes it produces: copy forwards, one byte at a time.
+                for (size_t k = 0; k < length; ++k, ++pos)
+                    dst[pos] = dst[pos - distance];
+            }
+        }
+    }
+}
+
+class CompressedSegmentWriter {
+    using BlockInfo = compressed_segment::BlockInfo;
+
+    ofstream out;
+    string filename;
+    size_t block_bytes;
+
+    // The block being filled by the caller.
+    string data;
+    vector<uint32_t> offsets;
+    uint64_t entries{0};
+    uint64_t block_first_entry{0};
+
+    // Handed over to the compressor thread: (first entry, raw block).
+    std::mutex mutex;
+    std::condition_variable changed;
+    deque<pair<uint64_t, string>> pending;
+    bool done{false};
+    std::thread compressor;
+
+    // Owned by the compressor thread until it is joined.
+    vector<BlockInfo> blocks;
+    uint64_t position{0};
+    uint64_t raw_total{0};
+
+    bool finished{false};
+
+    void compress_blocks() {
+        string compressed;
+        for (;;) {
+            pair<uint64_t, string> job;
+            {
+                std::unique_lock<std::mutex> lock{mutex};
+                changed.wait(lock, [this] { return done || !pending.empty(); });
+                if (pending.empty())
+                    return;
+                job = std::move(pending.front());
+                pending.pop_front();
+            }
+            changed.notify_all();
+
+            compressed_segment::compress(job.second, compressed);
+            blocks.push_back({position, static_cast<uint32_t>(compressed.size()),
+                              static_cast<uint32_t>(job.second.size()), job.first});
+            out.write(compressed.data(), compressed.size());
+            position += compressed.size();
+            raw_total += job.second.size();
+        }
+    }
+
+    void seal_block() {
+        if (offsets.empty())
+            return;
+
+        uint32_t count = offsets.size();
+        offsets.push_back(static_cast<uint32_t>(data.size()));
+        string raw;
+        raw.reserve(sizeof(uint32_t) * (offsets.size() + 1) + data.size());
+        raw.append(reinterpret_cast<const char*>(&count), sizeof(count));
+        raw.append(reinterpret_cast<const char*>(offsets.data()), offsets.size() * sizeof(uint32_t));
+        raw += data;
+
+        {
+            // At most a few blocks in flight, so a slow disk slows the caller down instead of growing memory.
+            std::unique_lock<std::mutex> lock{mutex};
+            changed.wait(lock, [this] { return pending.size() < 4; });
+            pending.emplace_back(block_first_entry, std::move(raw));
+        }
+        changed.notify_all();
+
+        data.clear();
+        offsets.clear();
+        block_first_entry = entries;
+    }
+
+    template <typename T> void put(const T &value) {
+        out.write(reinterpret_cast<const char*>(&value), sizeof(value));
+    }
+
+    /**
+     * Lets the compressor finish the blocks handed to it, and waits for it.
+     */
+    void stop_compressor() {
+        if (!compressor.joinable())
+            return;
+        {
+            std::lock_guard<std::mutex> lock{mutex};
+            done = true;
+        }
+        changed.notify_all();
+        compressor.join();
+    }
+
+public:
+    CompressedSegmentWriter(const string &filename, string_view title, size_t block_bytes = 16 * 1024)
+            : out(filename, ios::binary | ios::trunc), filename(filename), block_bytes(block_bytes) {
+        if (!out)
+            throw system_error(errno, generic_category(), "open " + filename);
+
+        out.write(compressed_segment::magic, sizeof(compressed_segment::magic));
+        put(compressed_segment::version);
+        put(uint64_t{0});
+        put(uint64_t{0});
+        put(uint64_t{0});
+        put(static_cast<uint32_t>(title.size()));
+        out.write(title.data(), title.size());
+        position = compressed_segment::header_size + title.size();
+
+        compressor = std::thread([this] { compress_blocks(); });
+    }
+
+    ~CompressedSegmentWriter() {
+        if (!finished) {
+            try {
+                finish();
+            } catch (...) {
+                // Nothing sensible to do with an I/O error while destroying.
+            }
+        }
+        // If finish() threw before joining, the compressor is still running.
+        stop_compressor();
+    }
+
+    void add(string_view entry) {
+        offsets.push_back(static_cast<uint32_t>(data.size()));
+        data.append(entry.data(), entry.size());
+        ++entries;
+        if (data.size() >= block_bytes)
+            seal_block();
+    }
+
+    void finish() {
+        finished = true;
+        seal_block();
+        stop_compressor();
+
+        static const char padding[8] = {};
+        auto pad = (8 - position % 8) % 8;
+        out.write(padding, pad);
+        uint64_t index_offset = position + pad;
+        out.write(reinterpret_cast<const char*>(blocks.data()), blocks.size() * sizeof(BlockInfo));
+
+        out.seekp(8);
+        put(entries);
+        put(static_cast<uint64_t>(blocks.size()));
+        put(index_offset);
+        out.close();
+        if (!out)
+            throw system_error(errno, generic_category(), "write " + filename);
+    }
+
+    /**
+     * Raw bytes of the blocks written so far; valid after finish().
+     */
+    uint64_t raw_bytes() const { return raw_total; }
+
+    static void write(const Journal &journal, const string &filename, size_t block_bytes = 16 * 1024) {
+        CompressedSegmentWriter writer{filename, journal.title, block_bytes};
+        for (auto &e: journal.entries)
+            writer.add(e);
+        writer.finish();
+    }
+};
+
+/**
+ * A read-only, memory-mapped compressed segment.
+ * Not thread-safe: entries are returned as views into the one cached block.
+ */
+class CompressedSegment {
+    using BlockInfo = compressed_segment::BlockInfo;
+
+    int fd{-1};
+    const char *base{nullptr};
+    size_t length{0};
+
+    string filename;
+    uint64_t count{0};
+    const BlockInfo *blocks{nullptr};
+    uint64_t block_count{0};
+    string_view title_view;
+
+    size_t cached_block{~size_t{0}};
+    string cache;
+
+    template <typename T> T get(size_t offset) const {
+        T value;
+        memcpy(&value, base + offset, sizeof(value));
+        return value;
+    }
+
+    void release() {
+        if (base)
+            ::munmap(const_cast<char*>(base), length);
+        if (fd >= 0)
+            ::close(fd);
+        base = nullptr;
+        fd = -1;
+    }
+
+    [[noreturn]] void corrupt(const char *what) {
+        release();
+        throw runtime_error(filename + ": not a compressed journal segment (" + what + ")");
+    }
+
+    /**
+     * Checks that every block lies between the title and the index, and that the blocks number their entries
+     * from 0 up to count, each holding at least one.
+     */
+    bool valid_blocks(uint64_t entries_begin, uint64_t index_offset) const {
+        if (block_count == 0)
+            return count == 0;
+        for (uint64_t b = 0; b < block_count; ++b) {
+            auto &block = blocks[b];
+            if (block.offset < entries_begin || block.offset > index_offset
+                || block.compressed_size > index_offset - block.offset
+                || (b == 0 ? block.first_entry != 0 : block.first_entry <= blocks[b - 1].first_entry)
+                || block.first_entry >= count)
+                return false;
+        }
+        return true;
+    }
+
+    /**
+     * Decompresses block b, and checks its entry count and offsets against the index and its raw size.
+     */
+    const string &load_block(size_t b) {
+        if (b == cached_block)
+            return cache;
+
+        cached_block = ~size_t{0};
+        auto &block = blocks[b];
+        try {
+            compressed_segment::decompress(base + block.offset, block.compressed_size, block.raw_size, cache);
+        } catch (const runtime_error &e) {
+            throw runtime_error(filename + ": block " + to_string(b) + ": " + e.what());
+        }
+
+        auto expected = (b + 1 < block_count ? blocks[b + 1].first_entry : count) - block.first_entry;
+        uint32_t entries_in_block = 0;
+        if (cache.size() >= sizeof(uint32_t))
+            memcpy(&entries_in_block, cache.data(), sizeof(entries_in_block));
+        auto header = sizeof(uint32_t) * (uint64_t{entries_in_block} + 2);
+        if (cache.size() < sizeof(uint32_t) || entries_in_block != expected || header > cache.size())
+            throw runtime_error(filename + ": block " + to_string(b) + " has a bad entry count");
+        uint32_t previous = 0;
+        for (uint64_t k = 0; k <= entries_in_block; ++k) {
+            uint32_t offset;
+            memcpy(&offset, cache.data() + sizeof(uint32_t) * (1 + k), sizeof(offset));
+            if (offset < previous || offset > cache.size() - header)
+                throw runtime_error(filename + ": block " + to_string(b) + " has an entry out of bounds");
+            previous = offset;
+        }
+
+        cached_block = b;
+        return cache;
+    }
+
+public:
+    explicit CompressedSegment(const string &filename) : filename(filename) {
+        fd = ::open(filename.c_str(), O_RDONLY);
+        if (fd < 0)
+            throw system_error(errno, generic_category(), "open " + filename);
+
+        struct stat st{};
+        if (::fstat(fd, &st) != 0) {
+            ::close(fd);
+            throw system_error(errno, generic_category(), "stat " + filename);
+        }
+        length = static_cast<size_t>(st.st_size);
+        if (length < compressed_segment::header_size) {
+            ::close(fd);
+            fd = -1;
+            corrupt("too short");
+        }
+
+        auto mapped = ::mmap(nullptr, length, PROT_READ, MAP_SHARED, fd, 0);
+        if (mapped == MAP_FAILED) {
+            ::close(fd);
+            throw system_error(errno, generic_category(), "mmap " + filename);
+        }
+        base = static_cast<const char*>(mapped);
+
+        if (memcmp(base, compressed_segment::magic, sizeof(compressed_segment::magic)) != 0
+            || get<uint32_t>(4) != compressed_segment::version)
+            corrupt("bad header");
+
+        count = get<uint64_t>(8);
+        block_count = get<uint64_t>(16);
+        auto index_offset = get<uint64_t>(24);
+        auto title_length = get<uint32_t>(32);
+        auto entries_begin = compressed_segment::header_size + title_length;
+        if (index_offset % 8 != 0 || index_offset > length
+            || block_count > (length - index_offset) / sizeof(BlockInfo) || entries_begin > index_offset)
+            corrupt("bad index");
+
+        blocks = reinterpret_cast<const BlockInfo*>(base + index_offset);
+        if (!valid_blocks(entries_begin, index_offset))
+            corrupt("bad block index");
+        title_view = {base + compressed_segment::header_size, title_length};
+    }
+
+    ~CompressedSegment() {
+        release();
+    }
+
+    CompressedSegment(const CompressedSegment&) = delete;
+    CompressedSegment &operator=(const CompressedSegment&) = delete;
+
+    string_view title() const { return title_view; }
+    size_t size() const { return count; }
+    size_t file_size() const { return length; }
+
+    /**
+     * Entry i, valid until an entry from a different block is read.
+     */
+    string_view operator[](size_t i) {
+        auto block = upper_bound(blocks, blocks + block_count, i,
+                                 [](uint64_t entry, const BlockInfo &b) { return entry < b.first_entry; }) - blocks - 1;
+        auto &raw = load_block(block);
+
+        auto local = i - blocks[block].first_entry;
+        auto offset_at = [&raw](size_t k) {
+            uint32_t v;
+            memcpy(&v, raw.data() + sizeof(uint32_t) * (1 + k), sizeof(v));
+            return v;
+        };
+        uint32_t entries_in_block;
+        memcpy(&entries_in_block, raw.data(), sizeof(entries_in_block));
+        auto data = raw.data() + sizeof(uint32_t) * (entries_in_block + 2);
+        auto begin = offset_at(local), end = offset_at(local + 1);
+        return {data + begin, end - begin};
+    }
+};
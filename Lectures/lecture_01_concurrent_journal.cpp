@@ -0,0 +1,68 @@
+#include <chrono>
+
+#include "lecture_01_concurrent_journal.h"
+#include "bench_util.h"
+
+/**
+ * Every thread adds its share of entries, first to one Journal behind a single mutex, then to a ConcurrentJournal,
+ * whose threads share neither a lock nor a counter on every entry. The merged journal must number its entries
+ * 1..N in order, and keep each thread's entries in the order it added them.
+ * Usage: lecture_01_concurrent_journal [threads] [entries per thread]
+ */
+int main(int argc, char *argv[]) {
+    size_t threads = argc > 1 ? stoul(argv[1]) : max(4u, thread::hardware_concurrency());
+    size_t per_thread = argc > 2 ? stoul(argv[2]) : 200'000;
+
+    // Separate journals number separately.
+    Journal diary{"Dear diary"}, notes{"Notes"};
+    diary.add_entry("I ate a bug");
+    notes.add_entry("Buy more bugs");
+    cout << diary.entries.front() << " / " << notes.entries.front() << endl;
+
+    auto run = [&](auto add_entry) {
+        vector<thread> workers;
+        auto start = chrono::steady_clock::now();
+        for (size_t t = 0; t < threads; ++t)
+            workers.emplace_back([&, t] {
+                string text = "thread " + to_string(t) + " entry ";
+                for (size_t i = 0; i < per_thread; ++i)
+                    add_entry(text + to_string(i));
+            });
+        for (auto &w: workers)
+            w.join();
+        return seconds_since(start);
+    };
+
+    Journal locked{"Locked"};
+    mutex lock;
+    auto locked_time = run([&](const string &entry) {
+        lock_guard<mutex> guard{lock};
+        locked.add_entry(entry);
+    });
+
+    ConcurrentJournal sharded{"Sharded"};
+    auto sharded_time = run([&](const string &entry) { sharded.add_entry(entry); });
+    auto merged = sharded.collect();
+
+    auto total = static_cast<double>(threads * per_thread);
+    cout << threads << " threads x " << per_thread << " entries" << endl
+         << "  Journal + mutex:   " << total / locked_time / 1e6 << " M entries/s" << endl
+         << "  ConcurrentJournal: " << total / sharded_time / 1e6 << " M entries/s" << endl;
+
+    if (merged.entries.size() != threads * per_thread) {
+        cerr << "Lost entries: " << merged.entries.size() << endl;
+        return 1;
+    }
+    vector<size_t> next_of_thread(threads, 0);
+    for (size_t i = 0; i < merged.entries.size(); ++i) {
+        auto &e = merged.entries[i];
+        size_t number, thread_index, entry_index;
+        if (sscanf(e.c_str(), "%zu: thread %zu entry %zu", &number, &thread_index, &entry_index) != 3
+            || number != i + 1 || entry_index != next_of_thread[thread_index]++) {
+            cerr << "Out of order: " << e << endl;
+            return 1;
+        }
+    }
+
+    return 0;
+}
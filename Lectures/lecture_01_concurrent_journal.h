@@ -0,0 +1,105 @@
+#pragma once
+
+#include <atomic>
+#include <functional>
+#include <mutex>
+#include <queue>
+#include <thread>
+
+#include "lecture_01_single_responsibility_principle.h"
+
+/**
+ * CONCURRENT JOURNAL
+ *
+ * Journal is a plain value: adding entries to one from several threads is a data race on its vector.
+ * Wrapping it in one mutex works, but every writer then queues on the same lock and the same cache line.
+ *
+ * ConcurrentJournal spreads writers over shards, chosen by thread id, so writers on different threads rarely
+ * meet. Each shard has its own lock, its own buffer, and its own block of sequence numbers to hand out. It takes
+ * a new block from the journal's shared counter only once every block_size entries, so writers do not fight
+ * over one counter either. A shard's blocks only grow, so each buffer is in sequence order, and so is each
+ * thread's share of it.
+ *
+ * Blocks are not used up evenly, so sequence numbers have gaps. collect() merges the shards in sequence order and
+ * numbers the entries 1..N in that order.
+ *
+ * That order keeps each thread's own entries in the order it added them, and nothing more. Entries of different
+ * threads are ordered by the blocks they came from, not by when they were added: if thread B adds x and then,
+ * after synchronizing with B, thread A adds y, y can still come first, from a block A took earlier. Code that
+ * needs one order across threads must add its entries from one thread, or through a plain Journal behind a mutex.
+ */
+class ConcurrentJournal {
+    struct alignas(64) Shard {
+        mutable std::mutex mutex;
+        vector<pair<size_t, string>> entries;  // (sequence number, entry)
+        size_t block_next{0};
+        size_t block_end{0};
+    };
+
+    static constexpr size_t block_size = 1024;
+
+    string title;
+    std::atomic<size_t> next_block{0};
+    vector<Shard> shards;
+
+    Shard &shard_for_this_thread() {
+        auto h = std::hash<std::thread::id>{}(std::this_thread::get_id());
+        return shards[h % shards.size()];
+    }
+
+public:
+    explicit ConcurrentJournal(const string &title, size_t shard_count = 2 * std::thread::hardware_concurrency())
+            : title(title), shards(max<size_t>(1, shard_count)) {}
+
+    /**
+     * Safe to call from any number of threads at once.
+     */
+    void add_entry(const string &entry) {
+        auto &shard = shard_for_this_thread();
+        std::lock_guard<std::mutex> lock{shard.mutex};
+        if (shard.block_next == shard.block_end) {
+            shard.block_next = next_block.fetch_add(block_size, std::memory_order_relaxed);
+            shard.block_end = shard.block_next + block_size;
+        }
+        shard.entries.emplace_back(shard.block_next++, entry);
+    }
+
+    size_t size() const {
+        size_t total = 0;
+        for (auto &s: shards) {
+            std::lock_guard<std::mutex> lock{s.mutex};
+            total += s.entries.size();
+        }
+        return total;
+    }
+
+    /**
+     * Merges the shards into a Journal, entries in sequence order and numbered from 1: each thread's entries in the
+     * order it added them. Call once the writers are done.
+     */
+    Journal collect() {
+        Journal journal{title};
+        journal.entries.reserve(size());
+
+        // k-way merge: the heap holds the next unmerged entry of each shard, smallest sequence number on top.
+        using Head = pair<size_t, size_t>;  // (sequence number, shard)
+        priority_queue<Head, vector<Head>, greater<Head>> heads;
+        vector<size_t> positions(shards.size(), 0);
+        for (size_t s = 0; s < shards.size(); ++s)
+            if (!shards[s].entries.empty())
+                heads.emplace(shards[s].entries.front().first, s);
+
+        while (!heads.empty()) {
+            auto s = heads.top().second;
+            heads.pop();
+            auto &entries = shards[s].entries;
+            journal.add_entry(entries[positions[s]].second);
+            if (++positions[s] < entries.size())
+                heads.emplace(entries[positions[s]].first, s);
+        }
+
+        for (auto &s: shards)
+            s.entries.clear();
+        return journal;
+    }
+};
@@ -0,0 +1,130 @@
+#include <chrono>
+#include <random>
+
+#include "lecture_01_journal_segment.h"
+#include "bench_util.h"
+
+/**
+ * Loads a journal the old way: parse the text written by PersistenceManager::save line by line.
+ */
+Journal load_text(const string &filename) {
+    ifstream in{filename};
+    string line;
+    getline(in, line);
+    Journal journal{line};
+    while (getline(in, line))
+        journal.entries.push_back(line);
+    return journal;
+}
+
+/**
+ * Builds a journal, saves it as text, converts it to a segment, and compares loading and random access.
+ */
+int demo(size_t n) {
+    Journal journal{"Dear diary"};
+    for (size_t i = 0; i < n; ++i)
+        journal.add_entry("Today I wrote entry number " + to_string(i));
+    PersistenceManager::save(journal, "diary.txt");
+    JournalSegmentWriter::convert_text("diary.txt", "diary.jseg");
+
+    auto start = chrono::steady_clock::now();
+    auto parsed = load_text("diary.txt");
+    auto parse_time = seconds_since(start);
+
+    start = chrono::steady_clock::now();
+    JournalSegment segment{"diary.jseg"};
+    auto open_time = seconds_since(start);
+
+    mt19937_64 rng{42};
+    size_t lookups = 1'000'000, total = 0;
+    start = chrono::steady_clock::now();
+    for (size_t i = 0; i < lookups; ++i)
+        total += segment[rng() % segment.size()].size();
+    auto lookup_time = seconds_since(start);
+
+    cout << n << " entries" << endl
+         << "  parse text:           " << parse_time * 1e3 << " ms" << endl
+         << "  open segment:         " << open_time * 1e6 << " us" << endl
+         << "  random entry lookups: " << lookups / lookup_time / 1e6 << " M/s (" << total << " bytes)" << endl;
+
+    if (segment.title() != journal.title || segment.size() != journal.entries.size()) {
+        cerr << "Segment header does not match the journal" << endl;
+        return 1;
+    }
+    for (size_t i = 0; i < segment.size(); ++i) {
+        if (segment[i] != journal.entries[i] || parsed.entries[i] != journal.entries[i]) {
+            cerr << "Entry " << i << " does not match" << endl;
+            return 1;
+        }
+    }
+
+    // Damaged copies of a small segment must be refused: a bad header when it is opened, a bad index when the entry
+    // is read or the segment verified. Nothing may be read out of bounds.
+    Journal small_journal{"Dear diary"};
+    for (auto entry: {"I ate a bug", "I cried today", "I ate another bug"})
+        small_journal.add_entry(entry);
+    JournalSegmentWriter::write(small_journal, "diary_small.jseg");
+    ifstream small_file{"diary_small.jseg", ios::binary};
+    string small{istreambuf_iterator<char>(small_file), {}};
+    auto refused = [&](size_t offset, uint64_t value) {
+        auto damaged = small;
+        memcpy(&damaged[offset], &value, sizeof(value));
+        ofstream{"diary_bad.jseg", ios::binary} << damaged;
+        auto throws = [](auto use) {
+            try {
+                JournalSegment bad{"diary_bad.jseg"};
+                use(bad);
+            } catch (const runtime_error &) {
+                return true;
+            }
+            return false;
+        };
+        return throws([](JournalSegment &bad) { bad.verify(); }) && throws([](JournalSegment &bad) {
+            for (size_t i = 0; i < bad.size(); ++i)
+                bad[i];
+        });
+    };
+    uint64_t index_offset;
+    memcpy(&index_offset, &small[16], sizeof(index_offset));
+    if (!refused(8, ~uint64_t{0}) || !refused(8, uint64_t{1} << 61) || !refused(index_offset, small.size())
+        || !refused(index_offset + 8, 0)) {
+        cerr << "A damaged segment was read" << endl;
+        return 1;
+    }
+    return 0;
+}
+
+/**
+ * Usage:
+ *   lecture_01_journal_segment convert <text file> <segment file>
+ *   lecture_01_journal_segment replay <segment file> [first entry] [count]
+ *   lecture_01_journal_segment verify <segment file>
+ *   lecture_01_journal_segment [entries]        (runs the demo)
+ */
+int main(int argc, char *argv[]) {
+    string command = argc > 1 ? argv[1] : "";
+
+    if (command == "convert" && argc == 4) {
+        JournalSegmentWriter::convert_text(argv[2], argv[3]);
+        return 0;
+    }
+
+    if (command == "verify" && argc == 3) {
+        JournalSegment segment{argv[2]};
+        segment.verify();
+        cout << argv[2] << ": " << segment.size() << " entries, all inside the segment" << endl;
+        return 0;
+    }
+
+    if (command == "replay" && argc >= 3) {
+        JournalSegment segment{argv[2]};
+        size_t first = argc > 3 ? stoull(argv[3]) : 0;
+        size_t count = argc > 4 ? stoull(argv[4]) : segment.size();
+        cout << segment.title() << '\n';
+        for (size_t i = first; i < segment.size() && i - first < count; ++i)
+            cout << segment[i] << '\n';
+        return 0;
+    }
+
+    return demo(argc > 1 ? stoull(argv[1]) : 1'000'000);
+}
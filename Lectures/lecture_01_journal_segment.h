@@ -0,0 +1,248 @@
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+#include <string_view>
+#include <system_error>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "lecture_01_single_responsibility_principle.h"
+
+/**
+ * JOURNAL SEGMENTS
+ *
+ * The text format written by PersistenceManager::save has to be parsed line by line to get a journal back, and
+ * there is no way to find entry N without reading the N - 1 before it.
+ *
+ * A segment is a binary file with an index:
+ *
+ *     header   magic "JSEG", version, entry count, offset of the index, title length, title
+ *     entries  the entry bytes, back to back, with no separators
+ *     index    entry count + 1 uint64 file offsets, 8-byte aligned; entry i spans [index[i], index[i + 1])
+ *
+ * Every number is little-endian. Writer and reader copy them in host byte order, so this only builds for
+ * little-endian hosts.
+ *
+ * JournalSegment maps the file into memory and checks the header, so opening takes the same time however big the
+ * segment is. Entry i is a string_view straight into the mapping; reading it checks the two index words it uses,
+ * so that a damaged index throws instead of reading out of bounds. Pages are faulted in as entries are touched.
+ * verify() checks every entry at once, for tools that want to know a segment is sound before using it.
+ */
+namespace journal_segment {
+    constexpr char magic[4] = {'J', 'S', 'E', 'G'};
+    constexpr uint32_t version = 1;
+
+    // magic, version, entry count, index offset, title length
+    constexpr size_t header_size = 4 + 4 + 8 + 8 + 4;
+
+    static_assert(__BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__, "journal segments are written in host byte order");
+}
+
+/**
+ * Writes a segment one entry at a time. The header is patched with the entry count and index position
+ * when the segment is finished.
+ */
+class JournalSegmentWriter {
+    ofstream out;
+    string filename;
+    vector<uint64_t> offsets;
+    uint64_t position{0};
+    bool finished{false};
+
+    template <typename T> void put(const T &value) {
+        out.write(reinterpret_cast<const char*>(&value), sizeof(value));
+    }
+
+public:
+    JournalSegmentWriter(const string &filename, string_view title)
+            : out(filename, ios::binary | ios::trunc), filename(filename) {
+        if (!out)
+            throw system_error(errno, generic_category(), "open " + filename);
+
+        out.write(journal_segment::magic, sizeof(journal_segment::magic));
+        put(journal_segment::version);
+        put(uint64_t{0});
+        put(uint64_t{0});
+        put(static_cast<uint32_t>(title.size()));
+        out.write(title.data(), title.size());
+        position = journal_segment::header_size + title.size();
+    }
+
+    ~JournalSegmentWriter() {
+        if (!finished) {
+            try {
+                finish();
+            } catch (...) {
+                // Nothing sensible to do with an I/O error while destroying.
+            }
+        }
+    }
+
+    void add(string_view entry) {
+        offsets.push_back(position);
+        out.write(entry.data(), entry.size());
+        position += entry.size();
+    }
+
+    void finish() {
+        finished = true;
+        uint64_t count = offsets.size();
+        offsets.push_back(position);
+
+        static const char padding[8] = {};
+        auto pad = (8 - position % 8) % 8;
+        out.write(padding, pad);
+        uint64_t index_offset = position + pad;
+        out.write(reinterpret_cast<const char*>(offsets.data()), offsets.size() * sizeof(uint64_t));
+
+        out.seekp(8);
+        put(count);
+        put(index_offset);
+        out.close();
+        if (!out)
+            throw system_error(errno, generic_category(), "write " + filename);
+    }
+
+    static void write(const Journal &journal, const string &filename) {
+        JournalSegmentWriter writer{filename, journal.title};
+        for (auto &e: journal.entries)
+            writer.add(e);
+        writer.finish();
+    }
+
+    /**
+     * Converts the text written by PersistenceManager::save: the first line is the title, every other line an entry.
+     */
+    static void convert_text(const string &text_filename, const string &segment_filename) {
+        ifstream in{text_filename};
+        if (!in)
+            throw system_error(errno, generic_category(), "open " + text_filename);
+        string line;
+        getline(in, line);
+        JournalSegmentWriter writer{segment_filename, line};
+        while (getline(in, line))
+            writer.add(line);
+        writer.finish();
+    }
+};
+
+/**
+ * A read-only, memory-mapped segment.
+ */
+class JournalSegment {
+    int fd{-1};
+    const char *base{nullptr};
+    size_t length{0};
+
+    uint64_t count{0};
+    const uint64_t *index{nullptr};
+    uint64_t entries_begin{0};
+    uint64_t index_offset{0};
+    string_view title_view;
+
+    template <typename T> T get(size_t offset) const {
+        T value;
+        memcpy(&value, base + offset, sizeof(value));
+        return value;
+    }
+
+    void release() {
+        if (base)
+            ::munmap(const_cast<char*>(base), length);
+        if (fd >= 0)
+            ::close(fd);
+        base = nullptr;
+        fd = -1;
+    }
+
+    [[noreturn]] void corrupt(const string &filename, const char *what) const {
+        throw runtime_error(filename + ": not a journal segment (" + what + ")");
+    }
+
+public:
+    explicit JournalSegment(const string &filename) {
+        fd = ::open(filename.c_str(), O_RDONLY);
+        if (fd < 0)
+            throw system_error(errno, generic_category(), "open " + filename);
+
+        struct stat st{};
+        if (::fstat(fd, &st) != 0) {
+            ::close(fd);
+            throw system_error(errno, generic_category(), "stat " + filename);
+        }
+        length = static_cast<size_t>(st.st_size);
+        if (length < journal_segment::header_size) {
+            ::close(fd);
+            corrupt(filename, "too short");
+        }
+
+        auto mapped = ::mmap(nullptr, length, PROT_READ, MAP_SHARED, fd, 0);
+        if (mapped == MAP_FAILED) {
+            ::close(fd);
+            throw system_error(errno, generic_category(), "mmap " + filename);
+        }
+        base = static_cast<const char*>(mapped);
+
+        if (memcmp(base, journal_segment::magic, sizeof(journal_segment::magic)) != 0
+            || get<uint32_t>(4) != journal_segment::version) {
+            release();
+            corrupt(filename, "bad header");
+        }
+
+        count = get<uint64_t>(8);
+        index_offset = get<uint64_t>(16);
+        auto title_length = get<uint32_t>(24);
+        entries_begin = journal_segment::header_size + title_length;
+        if (index_offset % 8 != 0 || index_offset > length || entries_begin > index_offset
+            || count >= (length - index_offset) / sizeof(uint64_t)) {
+            release();
+            corrupt(filename, "bad index");
+        }
+
+        index = reinterpret_cast<const uint64_t*>(base + index_offset);
+        title_view = {base + journal_segment::header_size, title_length};
+    }
+
+    ~JournalSegment() {
+        release();
+    }
+
+    JournalSegment(const JournalSegment&) = delete;
+    JournalSegment &operator=(const JournalSegment&) = delete;
+
+    string_view title() const { return title_view; }
+    size_t size() const { return count; }
+
+    /**
+     * Entry i, for i < size(). Throws runtime_error if the index puts it outside the entries.
+     */
+    string_view operator[](size_t i) const {
+        auto begin = index[i], end = index[i + 1];
+        if (begin < entries_begin || begin > end || end > index_offset)
+            throw runtime_error("journal segment: entry " + to_string(i) + " is outside the segment");
+        return {base + begin, end - begin};
+    }
+
+    /**
+     * Checks that every entry lies, in order, between the title and the index. This reads the whole index.
+     */
+    void verify() const {
+        for (size_t i = 0; i < count; ++i)
+            (*this)[i];
+    }
+
+    /**
+     * Copies the segment back into a Journal.
+     */
+    Journal to_journal() const {
+        Journal journal{string(title_view)};
+        journal.entries.reserve(count);
+        for (size_t i = 0; i < count; ++i)
+            journal.entries.emplace_back((*this)[i]);
+        return journal;
+    }
+};
@@ -0,0 +1,75 @@
+#include <thread>
+
+#include "lecture_01_journal_writer.h"
+#include "bench_util.h"
+
+/**
+ * Persists every new entry as it is added, first with PersistenceManager::save after each entry, then with a
+ * group-committing JournalWriter, and checks that both files end up identical.
+ * Usage: lecture_01_journal_writer [entries for save] [entries for writer]
+ */
+int main(int argc, char *argv[]) {
+    size_t save_entries = argc > 1 ? stoul(argv[1]) : 2'000;
+    size_t writer_entries = argc > 2 ? stoul(argv[2]) : 1'000'000;
+
+    Journal saved{"Dear diary"};
+    auto start = chrono::steady_clock::now();
+    for (size_t i = 0; i < save_entries; ++i) {
+        saved.add_entry("Today I wrote entry number " + to_string(i));
+        PersistenceManager::save(saved, "diary_save.txt");
+    }
+    auto save_time = seconds_since(start);
+
+    Journal written{"Dear diary"};
+    start = chrono::steady_clock::now();
+    {
+        JournalWriter writer{written, "diary_writer.txt"};
+        for (size_t i = 0; i < writer_entries; ++i) {
+            written.add_entry("Today I wrote entry number " + to_string(i));
+            writer.append(written);
+        }
+    }
+    auto writer_time = seconds_since(start);
+
+    cout << "  save after every entry:  " << save_entries / save_time << " appends/s"
+         << " (" << save_entries << " entries)" << endl
+         << "  JournalWriter:           " << writer_entries / writer_time << " appends/s"
+         << " (" << writer_entries << " entries)" << endl;
+
+    // The same journal, persisted both ways, must give the same file.
+    Journal journal{"Dear diary"};
+    {
+        JournalWriter writer{journal, "diary_writer.txt"};
+        for (auto entry: {"I ate a bug", "I cried today"}) {
+            journal.add_entry(entry);
+            writer.append(journal);
+        }
+    }
+    PersistenceManager::save(journal, "diary_save.txt");
+
+    auto read = [](const char *filename) {
+        ifstream file{filename};
+        return string{istreambuf_iterator<char>(file), {}};
+    };
+    auto saved_text = read("diary_save.txt");
+    if (saved_text != read("diary_writer.txt")) {
+        cerr << "The two files differ" << endl;
+        return 1;
+    }
+
+    // A burst, then nothing: the writer keeps the last batch until it is polled once its time is up.
+    Journal idle{"Dear diary"};
+    JournalWriter writer{idle, "diary_writer.txt", {256 * 1024, 4 * 1024 * 1024, chrono::milliseconds{50}}};
+    writer.commit();
+    for (auto entry: {"I ate a bug", "I cried today"}) {
+        idle.add_entry(entry);
+        writer.append(idle);
+    }
+    this_thread::sleep_until(writer.commit_due());
+    if (!writer.flush_if_due() || writer.pending() || read("diary_writer.txt") != saved_text) {
+        cerr << "flush_if_due did not commit the last batch" << endl;
+        return 1;
+    }
+
+    return 0;
+}
@@ -0,0 +1,138 @@
+#pragma once
+
+#include <chrono>
+#include <system_error>
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include "lecture_01_single_responsibility_principle.h"
+
+/**
+ * GROUP-COMMIT JOURNAL WRITER
+ *
+ * PersistenceManager::save reopens the file, rewrites every entry, and flushes after each line (endl).
+ * Saving after each new entry is therefore quadratic, and every line is a system call.
+ *
+ * JournalWriter is a persistence component for journals that only ever appends:
+ * - it remembers how many entries of the journal it has already written, and only writes the new ones;
+ * - entries are collected in a memory buffer, and written out when the buffer fills up;
+ * - durability is group-committed: one fsync covers every entry since the previous one, and happens once enough
+ *   bytes have accumulated or enough time has passed since the last commit, whichever comes first.
+ *
+ * Nothing runs in the background, so the time limit is only checked when the writer is called: by append, and by
+ * flush_if_due, which commits a batch whose time is up. A writer that may sit idle after a burst needs its owner to
+ * call flush_if_due (say, from its event loop, no later than commit_due()); otherwise the last batch stays
+ * unsynced until the next append or the destructor.
+ *
+ * The file has the same text format as PersistenceManager::save: the title, then one entry per line.
+ * Opening a writer starts the file afresh with the title and the journal's current entries.
+ */
+struct GroupCommitPolicy {
+    size_t buffer_bytes = 256 * 1024;             // write(2) once this much is buffered
+    size_t commit_bytes = 4 * 1024 * 1024;        // fsync once this much was written since the last fsync
+    chrono::milliseconds commit_interval{10};     // ... or once this long has passed since the last fsync
+    bool fsync = true;                            // false: leave durability to the OS
+};
+
+class JournalWriter {
+    int fd{-1};
+    string filename;
+    GroupCommitPolicy policy;
+
+    string buffer;
+    size_t persisted{0};
+    size_t uncommitted_bytes{0};
+    chrono::steady_clock::time_point last_commit;
+
+    void write_buffer() {
+        const char *data = buffer.data();
+        size_t left = buffer.size();
+        while (left > 0) {
+            auto n = ::write(fd, data, left);
+            if (n < 0) {
+                if (errno == EINTR)
+                    continue;
+                throw system_error(errno, generic_category(), "write " + filename);
+            }
+            data += n;
+            left -= static_cast<size_t>(n);
+        }
+        uncommitted_bytes += buffer.size();
+        buffer.clear();
+    }
+
+public:
+    JournalWriter(const Journal &journal, string filename, GroupCommitPolicy policy = {})
+            : filename(std::move(filename)), policy(policy), last_commit(chrono::steady_clock::now()) {
+        fd = ::open(this->filename.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_APPEND, 0644);
+        if (fd < 0)
+            throw system_error(errno, generic_category(), "open " + this->filename);
+        buffer.reserve(policy.buffer_bytes + 4096);
+        buffer += journal.title;
+        buffer += '\n';
+        append(journal);
+    }
+
+    ~JournalWriter() {
+        try {
+            commit();
+        } catch (...) {
+            // Nothing sensible to do with an I/O error while destroying.
+        }
+        ::close(fd);
+    }
+
+    JournalWriter(const JournalWriter&) = delete;
+    JournalWriter &operator=(const JournalWriter&) = delete;
+
+    /**
+     * Writes the entries added to the journal since the last call. Cheap when there is nothing new.
+     */
+    void append(const Journal &journal) {
+        for (; persisted < journal.entries.size(); ++persisted) {
+            buffer += journal.entries[persisted];
+            buffer += '\n';
+            if (buffer.size() >= policy.buffer_bytes)
+                write_buffer();
+        }
+
+        if (uncommitted_bytes + buffer.size() >= policy.commit_bytes
+            || chrono::steady_clock::now() - last_commit >= policy.commit_interval)
+            commit();
+    }
+
+    /**
+     * True if entries have been appended since the last commit.
+     */
+    bool pending() const { return !buffer.empty() || uncommitted_bytes > 0; }
+
+    /**
+     * When the pending entries are due to be committed by time.
+     */
+    chrono::steady_clock::time_point commit_due() const { return last_commit + policy.commit_interval; }
+
+    /**
+     * Commits the pending entries if their time is up. Returns whether it did.
+     */
+    bool flush_if_due() {
+        if (!pending() || chrono::steady_clock::now() < commit_due())
+            return false;
+        commit();
+        return true;
+    }
+
+    /**
+     * Writes everything buffered and makes it durable now.
+     */
+    void commit() {
+        if (!buffer.empty())
+            write_buffer();
+        if (policy.fsync && uncommitted_bytes > 0 && ::fsync(fd) != 0)
+            throw system_error(errno, generic_category(), "fsync " + filename);
+        uncommitted_bytes = 0;
+        last_commit = chrono::steady_clock::now();
+    }
+
+    size_t entries_written() const { return persisted; }
+};
@@ -0,0 +1,102 @@
+#include <chrono>
+#include <random>
+
+#include "lecture_02_bitmap_index.h"
+#include "bench_util.h"
+
+/**
+ * Runs the same queries repeatedly through BetterFilter and through the IndexedFilter, then checks that the index
+ * stays correct as products are removed and added.
+ * Usage: lecture_02_bitmap_index [products] [repetitions]
+ */
+int main(int argc, char *argv[]) {
+    size_t n = argc > 1 ? stoul(argv[1]) : 1'000'000;
+    size_t repetitions = argc > 2 ? stoul(argv[2]) : 20;
+
+    mt19937 rng{42};
+    vector<Product> products;
+    products.reserve(n);
+    for (size_t i = 0; i < n; ++i)
+        products.push_back({"Item", static_cast<Colour>(rng() % 3), static_cast<Size>(rng() % 3)});
+
+    vector<Product*> items;
+    IndexedFilter index;
+    for (auto &p: products) {
+        items.push_back(&p);
+        index.add(&p);
+    }
+
+    ColourSpecification green{Colour::green};
+    ColourSpecification blue{Colour::blue};
+    SizeSpecification large{Size::large};
+    auto green_or_blue = green || blue;
+    auto spec = green_or_blue && large;
+
+    BetterFilter bf;
+    size_t expected = 0;
+    auto start = chrono::steady_clock::now();
+    for (size_t r = 0; r < repetitions; ++r)
+        expected = bf.filter(items, spec).size();
+    auto scan_time = seconds_since(start);
+
+    size_t found = 0;
+    start = chrono::steady_clock::now();
+    for (size_t r = 0; r < repetitions; ++r) {
+        found = 0;
+        for (auto p: index.query(spec))
+            found += p != nullptr;
+    }
+    auto index_time = seconds_since(start);
+
+    cout << n << " products, (green || blue) && large: " << expected << " matches" << endl
+         << "  BetterFilter:  " << repetitions / scan_time << " queries/s" << endl
+         << "  IndexedFilter: " << repetitions / index_time << " queries/s" << endl;
+
+    if (found != expected) {
+        cerr << "Mismatch: index found " << found << " matches" << endl;
+        return 1;
+    }
+
+    // Churn: remove every third product, recolour some others, and check the index still agrees.
+    vector<Product*> remaining;
+    for (size_t i = 0; i < items.size(); ++i) {
+        if (i % 3 == 0) {
+            index.remove(items[i]);
+        } else {
+            if (i % 7 == 0) {
+                items[i]->colour = Colour::green;
+                index.update(items[i]);
+            }
+            remaining.push_back(items[i]);
+        }
+    }
+    Product extra{"Extra", Colour::blue, Size::large};
+    index.add(&extra);
+    remaining.push_back(&extra);
+
+    // Adding a product twice must not give it a second slot, which would match twice and outlive remove().
+    Product twice{"Twice", Colour::green, Size::large};
+    index.add(&twice);
+    twice.colour = Colour::blue;
+    index.add(&twice);
+    size_t seen = 0;
+    for (auto p: index.query(spec))
+        seen += p == &twice;
+    index.remove(&twice);
+    for (auto p: index.query(green_or_blue))
+        seen += p == &twice;
+    if (seen != 1 || index.size() != remaining.size()) {
+        cerr << "A product added twice was indexed twice" << endl;
+        return 1;
+    }
+
+    expected = bf.filter(remaining, spec).size();
+    found = index.query(spec).count();
+    cout << "After churn: " << found << " matches" << endl;
+    if (found != expected) {
+        cerr << "Mismatch after churn: expected " << expected << endl;
+        return 1;
+    }
+
+    return 0;
+}
@@ -0,0 +1,263 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <iterator>
+#include <unordered_map>
+
+#include "lecture_02_open_closed_principle_solution.h"
+
+/**
+ * BITMAP INDEXED FILTER
+ *
+ * When the same colour / size queries are run over and over against a mostly static set of products, it pays to
+ * keep an index: one bitmap per Colour value and one per Size value, where bit i says whether the product in slot
+ * i has that value. A conjunction is then a word-level AND of two bitmaps, and a disjunction a word-level OR.
+ *
+ * Products are added and removed one at a time, and only their own bits change.
+ * Queries never build a result vector: query() returns a range whose iterator combines the bitmaps one 64-bit
+ * word at a time and walks the set bits of that word.
+ */
+class IndexedFilter {
+    static constexpr size_t colour_count = 3;
+    static constexpr size_t size_count = 3;
+
+    vector<Product*> slots;
+    vector<size_t> free_slots;
+    unordered_map<const Product*, size_t> slot_of;
+
+    vector<uint64_t> live;
+    std::array<vector<uint64_t>, colour_count> colour_bitmaps;
+    std::array<vector<uint64_t>, size_count> size_bitmaps;
+
+    static void set_bit(vector<uint64_t> &bitmap, size_t slot) {
+        bitmap[slot / 64] |= uint64_t{1} << (slot % 64);
+    }
+
+    static void clear_bit(vector<uint64_t> &bitmap, size_t slot) {
+        bitmap[slot / 64] &= ~(uint64_t{1} << (slot % 64));
+    }
+
+    void index(const Product *p, size_t slot) {
+        set_bit(live, slot);
+        set_bit(colour_bitmaps[static_cast<size_t>(p->colour)], slot);
+        set_bit(size_bitmaps[static_cast<size_t>(p->size)], slot);
+    }
+
+    void unindex(size_t slot) {
+        clear_bit(live, slot);
+        for (auto &b: colour_bitmaps) clear_bit(b, slot);
+        for (auto &b: size_bitmaps) clear_bit(b, slot);
+    }
+
+public:
+    class Range;
+
+    /**
+     * Adding a product that is already in the index only re-indexes it, as update does: it keeps its one slot.
+     */
+    void add(Product *p) {
+        if (slot_of.count(p)) {
+            update(p);
+            return;
+        }
+
+        size_t slot;
+        if (!free_slots.empty()) {
+            slot = free_slots.back();
+            free_slots.pop_back();
+            slots[slot] = p;
+        } else {
+            slot = slots.size();
+            slots.push_back(p);
+            if (slot % 64 == 0) {
+                live.push_back(0);
+                for (auto &b: colour_bitmaps) b.push_back(0);
+                for (auto &b: size_bitmaps) b.push_back(0);
+            }
+        }
+        slot_of[p] = slot;
+        index(p, slot);
+    }
+
+    void remove(const Product *p) {
+        auto it = slot_of.find(p);
+        if (it == slot_of.end())
+            return;
+        unindex(it->second);
+        slots[it->second] = nullptr;
+        free_slots.push_back(it->second);
+        slot_of.erase(it);
+    }
+
+    /**
+     * Call after changing the colour or size of a product that is already in the index.
+     */
+    void update(const Product *p) {
+        auto it = slot_of.find(p);
+        if (it == slot_of.end())
+            return;
+        unindex(it->second);
+        index(p, it->second);
+    }
+
+    size_t size() const { return slot_of.size(); }
+
+    Range query(const Specification<Product> &spec) const;
+};
+
+/**
+ * A specification compiled into a small postfix program over bitmap words.
+ * It lives inline in the Range, so running a query allocates nothing.
+ */
+class IndexedFilter::Range {
+    friend class IndexedFilter;
+
+    enum class Op : uint8_t { colour, size, and_, or_, scan };
+    struct Instruction {
+        Op op;
+        uint8_t value;
+    };
+
+    static constexpr size_t max_program = 32;
+
+    const IndexedFilter *index;
+    const Specification<Product> *spec;
+    std::array<Instruction, max_program> program{};
+    size_t program_size{0};
+
+    Range(const IndexedFilter &index, const Specification<Product> &spec) : index(&index), spec(&spec) {
+        if (!compile(spec)) {
+            // Too deep to keep inline: answer the whole specification by scanning live products.
+            program_size = 0;
+            program[program_size++] = {Op::scan, 0};
+        }
+    }
+
+    bool emit(Op op, uint8_t value = 0) {
+        if (program_size == max_program)
+            return false;
+        program[program_size++] = {op, value};
+        return true;
+    }
+
+    bool compile(const Specification<Product> &s) {
+        if (auto c = dynamic_cast<const ColourSpecification*>(&s))
+            return emit(Op::colour, static_cast<uint8_t>(c->colour));
+        if (auto sz = dynamic_cast<const SizeSpecification*>(&s))
+            return emit(Op::size, static_cast<uint8_t>(sz->size));
+        if (auto a = dynamic_cast<const AndSpecification<Product>*>(&s))
+            return compile(a->s1) && compile(a->s2) && emit(Op::and_);
+        if (auto o = dynamic_cast<const OrSpecification<Product>*>(&s))
+            return compile(o->s1) && compile(o->s2) && emit(Op::or_);
+
+        // Not something the index knows about: only valid as the whole query.
+        return program_size == 0 && emit(Op::scan);
+    }
+
+    uint64_t evaluate(size_t word) const {
+        std::array<uint64_t, max_program> stack;
+        size_t top = 0;
+        for (size_t i = 0; i < program_size; ++i) {
+            const auto &in = program[i];
+            switch (in.op) {
+                case Op::colour:
+                    stack[top++] = index->colour_bitmaps[in.value][word];
+                    break;
+                case Op::size:
+                    stack[top++] = index->size_bitmaps[in.value][word];
+                    break;
+                case Op::and_:
+                    --top;
+                    stack[top - 1] &= stack[top];
+                    break;
+                case Op::or_:
+                    --top;
+                    stack[top - 1] |= stack[top];
+                    break;
+                case Op::scan: {
+                    uint64_t bits = 0;
+                    for (uint64_t w = index->live[word]; w; w &= w - 1) {
+                        auto bit = __builtin_ctzll(w);
+                        if (spec->is_satisfied(index->slots[word * 64 + bit]))
+                            bits |= uint64_t{1} << bit;
+                    }
+                    stack[top++] = bits;
+                    break;
+                }
+            }
+        }
+        // Removed slots are cleared in every bitmap, but mask anyway so a scan never sees them.
+        return stack[0] & index->live[word];
+    }
+
+public:
+    class iterator {
+        friend class Range;
+
+        const Range *range;
+        size_t word;
+        uint64_t bits;
+
+        iterator(const Range *range, size_t word) : range(range), word(word), bits(0) {
+            advance_to_nonempty();
+        }
+
+        void advance_to_nonempty() {
+            auto words = range->index->live.size();
+            while (word < words && (bits = range->evaluate(word)) == 0)
+                ++word;
+        }
+
+    public:
+        using iterator_category = forward_iterator_tag;
+        using value_type = Product*;
+        using difference_type = ptrdiff_t;
+        using pointer = Product* const*;
+        using reference = Product*;
+
+        Product *operator*() const {
+            return range->index->slots[word * 64 + __builtin_ctzll(bits)];
+        }
+
+        iterator &operator++() {
+            bits &= bits - 1;
+            if (!bits) {
+                ++word;
+                advance_to_nonempty();
+            }
+            return *this;
+        }
+
+        iterator operator++(int) {
+            auto old = *this;
+            ++*this;
+            return old;
+        }
+
+        bool operator==(const iterator &other) const {
+            return word == other.word && bits == other.bits;
+        }
+
+        bool operator!=(const iterator &other) const {
+            return !(*this == other);
+        }
+    };
+
+    iterator begin() const { return {this, 0}; }
+    iterator end() const { return {this, index->live.size()}; }
+
+    /**
+     * Number of matches, counted a word at a time without visiting the products.
+     */
+    size_t count() const {
+        size_t total = 0;
+        for (size_t w = 0; w < index->live.size(); ++w)
+            total += __builtin_popcountll(evaluate(w));
+        return total;
+    }
+};
+
+inline IndexedFilter::Range IndexedFilter::query(const Specification<Product> &spec) const {
+    return {*this, spec};
+}
@@ -0,0 +1,76 @@
+#include <chrono>
+#include <random>
+
+#include "lecture_02_product_table.h"
+#include "bench_util.h"
+
+/**
+ * Compares BetterFilter over a vector<Product*> with the ColumnarFilter over a ProductTable.
+ * Usage: lecture_02_columnar_filter [products]
+ */
+int main(int argc, char *argv[]) {
+    size_t n = argc > 1 ? stoul(argv[1]) : 4'000'000;
+    const string names[] = {"Apple", "Tree", "House", "Car", "Shirt", "Lamp"};
+
+    mt19937 rng{42};
+    vector<Product> products;
+    products.reserve(n);
+    for (size_t i = 0; i < n; ++i)
+        products.push_back({names[rng() % 6], static_cast<Colour>(rng() % 3), static_cast<Size>(rng() % 3)});
+
+    // Shuffled pointers, as a catalog that was built up over time would have.
+    vector<Product*> items;
+    items.reserve(n);
+    for (auto &p: products)
+        items.push_back(&p);
+    shuffle(items.begin(), items.end(), rng);
+
+    ProductTable table;
+    table.reserve(n);
+    for (auto p: items)
+        table.add(*p);
+
+    ColourSpecification green{Colour::green};
+    ColourSpecification blue{Colour::blue};
+    SizeSpecification large{Size::large};
+    SizeSpecification small{Size::small};
+    auto green_and_large = green && large;
+    auto green_or_blue = green || blue;
+    auto complex = green_or_blue && small;
+
+    BetterFilter bf;
+    ColumnarFilter cf;
+    const pair<string, const Specification<Product>*> queries[] = {
+            {"green && large", &green_and_large},
+            {"(green || blue) && small", &complex},
+    };
+
+    cout << n << " products" << endl;
+    for (auto &[label, spec]: queries) {
+        auto start = chrono::steady_clock::now();
+        auto pointer_result = bf.filter(items, *spec);
+        auto pointer_time = seconds_since(start);
+
+        start = chrono::steady_clock::now();
+        auto bitmap = cf.filter(table, *spec);
+        auto columnar_time = seconds_since(start);
+
+        cout << label << ": " << pointer_result.size() << " matches" << endl
+             << "  pointer chasing: " << n / pointer_time / 1e6 << " M products/s" << endl
+             << "  columnar:        " << n / columnar_time / 1e6 << " M products/s" << endl;
+
+        if (bitmap.count() != pointer_result.size()) {
+            cerr << "Mismatch: columnar filter found " << bitmap.count() << " matches" << endl;
+            return 1;
+        }
+    }
+
+    // The first few matches, read back out of the table.
+    size_t shown = 0;
+    cf.filter(table, green_and_large).for_each([&](size_t row) {
+        if (shown++ < 3)
+            cout << table.name(row) << " is green and large." << endl;
+    });
+
+    return 0;
+}
@@ -0,0 +1,64 @@
+#include <chrono>
+#include <random>
+
+#include "lecture_02_filter_view.h"
+#include "bench_util.h"
+
+/**
+ * The solution's main, written with a view instead of a result vector, followed by a comparison against
+ * BetterFilter when only the first page of results is wanted.
+ * Usage: lecture_02_filter_view [products]
+ */
+int main(int argc, char *argv[]) {
+    Product apple{"Apple", Colour::green, Size::small};
+    Product tree{"Tree",   Colour::green, Size::large};
+    Product house{"House", Colour::blue,  Size::large};
+    vector<Product*> items {&apple, &tree, &house};
+
+    ColourSpecification green{Colour::green};
+    SizeSpecification large{Size::large};
+    for (auto i : filtered(items, green).where(large))
+        cout << i->name << " is green and large." << endl;
+
+    // Views work over ranges of products as well as ranges of pointers.
+    vector<Product> catalog {apple, tree, house};
+    for (auto &p : filtered(catalog, large).take(1))
+        cout << p.name << " is the first large product." << endl;
+
+    size_t n = argc > 1 ? stoul(argv[1]) : 4'000'000;
+    mt19937 rng{42};
+    vector<Product> products;
+    products.reserve(n);
+    for (size_t i = 0; i < n; ++i)
+        products.push_back({"Item", static_cast<Colour>(rng() % 3), static_cast<Size>(rng() % 3)});
+    vector<Product*> many;
+    many.reserve(n);
+    for (auto &p: products)
+        many.push_back(&p);
+
+    // Third page of 20 green, large products.
+    const size_t page = 2, page_size = 20;
+    auto green_and_large = green && large;
+
+    BetterFilter bf;
+    auto start = chrono::steady_clock::now();
+    auto all = bf.filter(many, green_and_large);
+    vector<Product*> expected(all.begin() + page * page_size, all.begin() + (page + 1) * page_size);
+    auto vector_time = seconds_since(start);
+
+    start = chrono::steady_clock::now();
+    auto view = filtered(many, green).where(large).page(page, page_size);
+    vector<Product*> paged(view.begin(), view.end());
+    auto view_time = seconds_since(start);
+
+    cout << n << " products, page " << page << " of green and large:" << endl
+         << "  BetterFilter then slice: " << vector_time * 1e6 << " us" << endl
+         << "  lazy view:               " << view_time * 1e6 << " us" << endl;
+
+    if (paged != expected || filtered(many, green_and_large).count() != all.size()) {
+        cerr << "Mismatch between view and BetterFilter" << endl;
+        return 1;
+    }
+
+    return 0;
+}
@@ -0,0 +1,142 @@
+#pragma once
+
+#include <iterator>
+#include <limits>
+#include <type_traits>
+
+#include "lecture_02_open_closed_principle_solution.h"
+
+/**
+ * LAZY FILTER VIEWS
+ *
+ * BetterFilter::filter builds a new vector<T*> for every query, even when the caller only walks the result once.
+ * A FilterView instead sits on top of any input range and checks the specification as it is iterated, so nothing
+ * is ever allocated:
+ *
+ *     for (auto p: filtered(items, green).where(large).take(10)) ...
+ *
+ * - where(spec) chains a further specification; the result is a view over this view.
+ * - take(n) stops after n matches, so the rest of the input is never looked at.
+ * - skip(n) and page(index, size) give pagination over the matches.
+ *
+ * The input may hold T* (like the vector<Product*> the filters use) or T itself.
+ * Views only hold iterators and a pointer to the specification, so the underlying range and the specification
+ * must outlive the view.
+ */
+
+template <typename X> X *as_item_pointer(X *x) { return x; }
+template <typename X> const X *as_item_pointer(const X &x) { return &x; }
+
+template <typename It, typename T> class FilterView {
+    It first, last;
+    const Specification<T> *spec;
+    size_t skip_n{0};
+    size_t take_n{numeric_limits<size_t>::max()};
+
+public:
+    class iterator {
+        friend class FilterView;
+
+        It current, last;
+        const Specification<T> *spec;
+        size_t remaining;
+
+        iterator(It current, It last, const Specification<T> *spec, size_t remaining)
+                : current(current), last(last), spec(spec), remaining(remaining) {
+            if (remaining == 0)
+                this->current = last;
+            else
+                seek();
+        }
+
+        void seek() {
+            while (current != last && !spec->is_satisfied(as_item_pointer(*current)))
+                ++current;
+        }
+
+    public:
+        using iterator_category = forward_iterator_tag;
+        using value_type = typename iterator_traits<It>::value_type;
+        using difference_type = ptrdiff_t;
+        using pointer = typename iterator_traits<It>::pointer;
+        using reference = typename iterator_traits<It>::reference;
+
+        reference operator*() const { return *current; }
+
+        iterator &operator++() {
+            if (--remaining == 0) {
+                current = last;
+            } else {
+                ++current;
+                seek();
+            }
+            return *this;
+        }
+
+        iterator operator++(int) {
+            auto old = *this;
+            ++*this;
+            return old;
+        }
+
+        bool operator==(const iterator &other) const { return current == other.current; }
+        bool operator!=(const iterator &other) const { return current != other.current; }
+    };
+
+    FilterView(It first, It last, const Specification<T> &spec) : first(first), last(last), spec(&spec) {}
+
+    iterator begin() const {
+        iterator it{first, last, spec, numeric_limits<size_t>::max()};
+        for (size_t i = 0; i < skip_n && it.current != last; ++i)
+            ++it;
+        it.remaining = take_n;
+        if (take_n == 0)
+            it.current = last;
+        return it;
+    }
+
+    iterator end() const { return {last, last, spec, 0}; }
+
+    bool empty() const { return begin() == end(); }
+
+    /**
+     * Counts the matches by walking them: this is O(input), not O(1).
+     */
+    size_t count() const {
+        size_t n = 0;
+        for (auto it = begin(); it != end(); ++it)
+            ++n;
+        return n;
+    }
+
+    FilterView<iterator, T> where(const Specification<T> &other) const {
+        return {begin(), end(), other};
+    }
+
+    FilterView take(size_t n) const {
+        auto view = *this;
+        view.take_n = min(take_n, n);
+        return view;
+    }
+
+    FilterView skip(size_t n) const {
+        auto view = *this;
+        view.skip_n += n;
+        view.take_n = take_n == numeric_limits<size_t>::max() ? take_n : take_n - min(take_n, n);
+        return view;
+    }
+
+    FilterView page(size_t index, size_t page_size) const {
+        return skip(index * page_size).take(page_size);
+    }
+};
+
+/**
+ * Entry point: a lazy view of the items in range that satisfy spec.
+ */
+template <typename Range, typename T>
+auto filtered(const Range &range, const Specification<T> &spec) {
+    using std::begin;
+    using std::end;
+    return FilterView<decltype(begin(range)), T>{begin(range), end(range), spec};
+}
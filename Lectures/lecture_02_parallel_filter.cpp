@@ -0,0 +1,84 @@
+#include <chrono>
+#include <random>
+
+#include "lecture_02_parallel_filter.h"
+#include "bench_util.h"
+
+/**
+ * A specification that fails on one product, to check that the error reaches the caller.
+ */
+struct FailingSpecification : Specification<Product> {
+    const Product *bad;
+
+    explicit FailingSpecification(const Product *bad) : bad(bad) {}
+
+    bool is_satisfied(const Product *const item) const override {
+        if (item == bad)
+            throw runtime_error("cannot judge this product");
+        return true;
+    }
+};
+
+/**
+ * Sweeps the ParallelFilter over thread counts 1, 2, 4, ... up to the hardware concurrency (or the given maximum),
+ * and compares each run against BetterFilter.
+ * Usage: lecture_02_parallel_filter [products] [max threads]
+ */
+int main(int argc, char *argv[]) {
+    size_t n = argc > 1 ? stoul(argv[1]) : 10'000'000;
+    size_t max_threads = argc > 2 ? stoul(argv[2]) : max(1u, thread::hardware_concurrency());
+
+    mt19937 rng{42};
+    vector<Product> products;
+    products.reserve(n);
+    for (size_t i = 0; i < n; ++i)
+        products.push_back({"Item", static_cast<Colour>(rng() % 3), static_cast<Size>(rng() % 3)});
+
+    vector<Product*> items;
+    items.reserve(n);
+    for (auto &p: products)
+        items.push_back(&p);
+
+    ColourSpecification green{Colour::green};
+    SizeSpecification large{Size::large};
+    auto spec = green && large;
+
+    BetterFilter bf;
+    auto start = chrono::steady_clock::now();
+    auto expected = bf.filter(items, spec);
+    auto sequential_time = seconds_since(start);
+
+    cout << n << " products, " << expected.size() << " matches" << endl
+         << "  BetterFilter:        " << sequential_time * 1e3 << " ms" << endl;
+
+    for (size_t threads = 1; threads <= max_threads; threads *= 2) {
+        WorkerPool pool{threads};
+        ParallelFilter<Product> pf{pool};
+
+        start = chrono::steady_clock::now();
+        auto result = pf.filter(items, spec);
+        auto parallel_time = seconds_since(start);
+
+        cout << "  ParallelFilter x" << threads << ": " << parallel_time * 1e3 << " ms"
+             << " (speedup " << sequential_time / parallel_time << ")" << endl;
+
+        if (result != expected) {
+            cerr << "Mismatch with " << threads << " threads" << endl;
+            return 1;
+        }
+
+        // A throwing specification must reach the caller, and leave the pool usable.
+        bool thrown = false;
+        try {
+            pf.filter(items, FailingSpecification{items[n / 2]});
+        } catch (const runtime_error &) {
+            thrown = true;
+        }
+        if (!thrown || pf.filter(items, spec) != expected) {
+            cerr << "A failing specification broke the filter with " << threads << " threads" << endl;
+            return 1;
+        }
+    }
+
+    return 0;
+}
@@ -0,0 +1,59 @@
+#pragma once
+
+#include <algorithm>
+
+#include "lecture_02_open_closed_principle_solution.h"
+#include "worker_pool.h"
+
+/**
+ * PARALLEL FILTER
+ *
+ * Another Filter<T>: nothing about the specifications has to change for it to be used.
+ *
+ * The input is cut into chunks small enough that a chunk's pointers and the products they point at stay in
+ * cache while the chunk is filtered. Workers claim chunks from the pool and keep their matches in a per-chunk
+ * buffer. A prefix sum over the chunk match counts gives each chunk its offset in the result, and the chunks
+ * are then copied into place in parallel, so the result is in the original order.
+ *
+ * Small inputs are not worth waking the pool for: below sequential_threshold the filter runs on the calling thread.
+ * The specification is called concurrently from several threads, so it must not mutate shared state. If it throws,
+ * filter stops early and rethrows the exception, and the pool can be used again.
+ */
+template <typename T> class ParallelFilter : public Filter<T> {
+    WorkerPool &pool;
+    size_t chunk_size;
+    size_t sequential_threshold;
+
+public:
+    explicit ParallelFilter(WorkerPool &pool, size_t chunk_size = 16 * 1024, size_t sequential_threshold = 64 * 1024)
+            : pool(pool), chunk_size(max<size_t>(1, chunk_size)), sequential_threshold(sequential_threshold) {}
+
+    vector<T*> filter(const vector<T*> &items, const Specification<T> &spec) override {
+        vector<T*> result;
+        if (items.size() < sequential_threshold || pool.size() == 1) {
+            copy_if(items.cbegin(), items.cend(), back_inserter(result),
+                    [&spec](auto x) { return spec.is_satisfied(x); });
+            return result;
+        }
+
+        size_t chunks = (items.size() + chunk_size - 1) / chunk_size;
+        vector<vector<T*>> matches(chunks);
+        pool.parallel_for(chunks, [&](size_t c) {
+            auto first = items.cbegin() + c * chunk_size;
+            auto last = items.cbegin() + min(items.size(), (c + 1) * chunk_size);
+            auto &out = matches[c];
+            copy_if(first, last, back_inserter(out), [&spec](auto x) { return spec.is_satisfied(x); });
+        });
+
+        vector<size_t> offsets(chunks + 1, 0);
+        for (size_t c = 0; c < chunks; ++c)
+            offsets[c + 1] = offsets[c] + matches[c].size();
+
+        result.resize(offsets.back());
+        pool.parallel_for(chunks, [&](size_t c) {
+            copy(matches[c].cbegin(), matches[c].cend(), result.begin() + offsets[c]);
+            vector<T*>{}.swap(matches[c]);
+        });
+        return result;
+    }
+};
@@ -0,0 +1,200 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <string_view>
+#include <unordered_map>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+#include "lecture_02_open_closed_principle_solution.h"
+
+/**
+ * COLUMNAR PRODUCT STORE
+ *
+ * BetterFilter walks a vector<Product*>, so every check is a pointer chase plus a virtual call.
+ * For large catalogs we instead keep the products as a structure of arrays: one byte per product for the
+ * colour, one byte for the size, and an id into a table of interned names.
+ *
+ * The Specification<Product> classes are still the front end: the ColumnarFilter below looks at the shape of
+ * the specification and turns colour / size checks into byte-compare kernels over the columns, and && / ||
+ * into word-level AND / OR over the resulting selection bitmaps.
+ */
+
+/**
+ * One bit per row of a ProductTable. Bit i is set if row i was selected.
+ */
+class SelectionBitmap {
+    vector<uint64_t> words;
+    size_t rows{0};
+
+public:
+    SelectionBitmap() = default;
+    explicit SelectionBitmap(size_t rows) : words((rows + 63) / 64, 0), rows(rows) {}
+
+    size_t size() const { return rows; }
+    size_t word_count() const { return words.size(); }
+
+    uint64_t *data() { return words.data(); }
+    const uint64_t *data() const { return words.data(); }
+
+    bool test(size_t row) const {
+        return (words[row / 64] >> (row % 64)) & 1u;
+    }
+
+    size_t count() const {
+        size_t total = 0;
+        for (auto w: words)
+            total += __builtin_popcountll(w);
+        return total;
+    }
+
+    SelectionBitmap &operator&=(const SelectionBitmap &other) {
+        for (size_t i = 0; i < words.size(); ++i)
+            words[i] &= other.words[i];
+        return *this;
+    }
+
+    SelectionBitmap &operator|=(const SelectionBitmap &other) {
+        for (size_t i = 0; i < words.size(); ++i)
+            words[i] |= other.words[i];
+        return *this;
+    }
+
+    /**
+     * Calls f(row) for every selected row, in increasing order.
+     */
+    template <typename F> void for_each(F &&f) const {
+        for (size_t i = 0; i < words.size(); ++i) {
+            for (uint64_t w = words[i]; w; w &= w - 1)
+                f(i * 64 + __builtin_ctzll(w));
+        }
+    }
+};
+
+/**
+ * Structure-of-arrays storage for products.
+ * Names are interned, so a catalog with many products of the same name stores the string only once.
+ */
+class ProductTable {
+    vector<uint8_t> colours;
+    vector<uint8_t> sizes;
+    vector<uint32_t> name_ids;
+
+    vector<string> names;
+    unordered_map<string, uint32_t> name_index;
+
+public:
+    size_t add(const Product &p) {
+        auto [it, inserted] = name_index.try_emplace(p.name, static_cast<uint32_t>(names.size()));
+        if (inserted)
+            names.push_back(p.name);
+
+        colours.push_back(static_cast<uint8_t>(p.colour));
+        sizes.push_back(static_cast<uint8_t>(p.size));
+        name_ids.push_back(it->second);
+        return colours.size() - 1;
+    }
+
+    void reserve(size_t n) {
+        colours.reserve(n);
+        sizes.reserve(n);
+        name_ids.reserve(n);
+    }
+
+    size_t size() const { return colours.size(); }
+
+    const uint8_t *colour_column() const { return colours.data(); }
+    const uint8_t *size_column() const { return sizes.data(); }
+
+    string_view name(size_t row) const { return names[name_ids[row]]; }
+    Colour colour(size_t row) const { return static_cast<Colour>(colours[row]); }
+    Size size(size_t row) const { return static_cast<Size>(sizes[row]); }
+
+    /**
+     * Rebuilds a row as a Product. Only used for specifications the columnar engine does not understand.
+     */
+    Product product(size_t row) const {
+        return {names[name_ids[row]], colour(row), size(row)};
+    }
+};
+
+/**
+ * The byte-compare kernel: sets bit i of out for every i where column[i] == value.
+ */
+inline void select_equal(const uint8_t *column, size_t rows, uint8_t value, uint64_t *out) {
+    size_t full_words = rows / 64;
+
+#if defined(__SSE2__)
+    const __m128i needle = _mm_set1_epi8(static_cast<char>(value));
+    for (size_t w = 0; w < full_words; ++w) {
+        const uint8_t *p = column + w * 64;
+        uint64_t m0 = static_cast<uint16_t>(_mm_movemask_epi8(
+                _mm_cmpeq_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(p)), needle)));
+        uint64_t m1 = static_cast<uint16_t>(_mm_movemask_epi8(
+                _mm_cmpeq_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(p + 16)), needle)));
+        uint64_t m2 = static_cast<uint16_t>(_mm_movemask_epi8(
+                _mm_cmpeq_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(p + 32)), needle)));
+        uint64_t m3 = static_cast<uint16_t>(_mm_movemask_epi8(
+                _mm_cmpeq_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(p + 48)), needle)));
+        out[w] = m0 | (m1 << 16) | (m2 << 32) | (m3 << 48);
+    }
+#else
+    for (size_t w = 0; w < full_words; ++w) {
+        const uint8_t *p = column + w * 64;
+        uint64_t mask = 0;
+        for (size_t b = 0; b < 64; ++b)
+            mask |= static_cast<uint64_t>(p[b] == value) << b;
+        out[w] = mask;
+    }
+#endif
+
+    // The tail that does not fill a whole word.
+    if (rows % 64) {
+        uint64_t mask = 0;
+        for (size_t b = 0; b < rows % 64; ++b)
+            mask |= static_cast<uint64_t>(column[full_words * 64 + b] == value) << b;
+        out[full_words] = mask;
+    }
+}
+
+/**
+ * Evaluates a Specification<Product> against a ProductTable, producing a selection bitmap.
+ *
+ * Colour and size specifications, and any &&/|| combination of them, run as column kernels.
+ * Any other specification still works: it falls back to calling is_satisfied on each rebuilt row.
+ */
+struct ColumnarFilter {
+    SelectionBitmap filter(const ProductTable &table, const Specification<Product> &spec) const {
+        if (auto c = dynamic_cast<const ColourSpecification*>(&spec)) {
+            SelectionBitmap result{table.size()};
+            select_equal(table.colour_column(), table.size(), static_cast<uint8_t>(c->colour), result.data());
+            return result;
+        }
+        if (auto s = dynamic_cast<const SizeSpecification*>(&spec)) {
+            SelectionBitmap result{table.size()};
+            select_equal(table.size_column(), table.size(), static_cast<uint8_t>(s->size), result.data());
+            return result;
+        }
+        if (auto a = dynamic_cast<const AndSpecification<Product>*>(&spec)) {
+            auto result = filter(table, a->s1);
+            result &= filter(table, a->s2);
+            return result;
+        }
+        if (auto o = dynamic_cast<const OrSpecification<Product>*>(&spec)) {
+            auto result = filter(table, o->s1);
+            result |= filter(table, o->s2);
+            return result;
+        }
+
+        SelectionBitmap result{table.size()};
+        for (size_t row = 0; row < table.size(); ++row) {
+            auto p = table.product(row);
+            if (spec.is_satisfied(&p))
+                result.data()[row / 64] |= uint64_t{1} << (row % 64);
+        }
+        return result;
+    }
+};
@@ -0,0 +1,72 @@
+#include <chrono>
+#include <random>
+
+#include "lecture_02_query_cache.h"
+#include "bench_util.h"
+
+/**
+ * Replays a workload of recurring queries with occasional catalog changes, with and without the cache.
+ * Usage: lecture_02_query_cache [products] [queries] [queries between mutations]
+ */
+int main(int argc, char *argv[]) {
+    size_t n = argc > 1 ? stoul(argv[1]) : 200'000;
+    size_t queries = argc > 2 ? stoul(argv[2]) : 2'000;
+    size_t mutate_every = argc > 3 ? stoul(argv[3]) : 100;
+
+    mt19937 rng{42};
+    vector<Product> products;
+    products.reserve(n + queries);
+    ProductCatalog catalog;
+    for (size_t i = 0; i < n; ++i) {
+        products.push_back({"Item", static_cast<Colour>(rng() % 3), static_cast<Size>(rng() % 3)});
+        catalog.add(&products.back());
+    }
+
+    ColourSpecification green{Colour::green};
+    ColourSpecification blue{Colour::blue};
+    SizeSpecification large{Size::large};
+    SizeSpecification small{Size::small};
+
+    // Several spellings of the same few queries.
+    auto green_and_large = green && large;
+    auto large_and_green = large && green;
+    auto green_or_blue = green || blue;
+    auto blue_or_green = blue || green;
+    auto gob_and_small = green_or_blue && small;
+    auto small_and_bog = small && blue_or_green;
+    const Specification<Product> *workload[] = {
+            &green_and_large, &large_and_green, &gob_and_small, &small_and_bog, &green, &large,
+    };
+
+    BetterFilter bf;
+    CachedFilter cache{catalog};
+
+    double uncached_time = 0, cached_time = 0;
+    for (size_t q = 0; q < queries; ++q) {
+        if (q && q % mutate_every == 0) {
+            products.push_back({"New", static_cast<Colour>(rng() % 3), static_cast<Size>(rng() % 3)});
+            catalog.add(&products.back());
+        }
+        auto &spec = *workload[rng() % size(workload)];
+
+        auto start = chrono::steady_clock::now();
+        auto expected = bf.filter(catalog.items(), spec);
+        uncached_time += seconds_since(start);
+
+        start = chrono::steady_clock::now();
+        auto result = cache.filter(spec);
+        cached_time += seconds_since(start);
+
+        if (*result != expected) {
+            cerr << "Mismatch on query " << q << endl;
+            return 1;
+        }
+    }
+
+    cout << n << " products, " << queries << " queries, a mutation every " << mutate_every << endl
+         << "  BetterFilter: " << queries / uncached_time << " queries/s" << endl
+         << "  CachedFilter: " << queries / cached_time << " queries/s" << endl
+         << "  " << cache.stats() << endl;
+
+    return 0;
+}
@@ -0,0 +1,212 @@
+#pragma once
+
+#include <algorithm>
+#include <list>
+#include <memory>
+#include <optional>
+#include <unordered_map>
+
+#include "lecture_02_open_closed_principle_solution.h"
+
+/**
+ * QUERY RESULT CACHE
+ *
+ * The same composite specifications (green && large, ...) are asked for over and over. A CachedFilter sits in
+ * front of BetterFilter and remembers result sets:
+ *
+ * - A specification tree is canonicalized into a string key: && and || are flattened, their operands sorted and
+ *   deduplicated, so large && green and green && (large && green) share an entry. Specifications other than
+ *   colour, size, && and || have no structure to compare, so queries involving them bypass the cache.
+ * - The products live in a ProductCatalog that bumps a generation counter on every mutation. A CachedFilter is
+ *   bound to one catalog for its whole life. Each entry remembers the generation it was computed at, and is
+ *   recomputed when the catalog has moved on.
+ * - Entries are evicted least-recently-used first once their estimated memory passes a budget.
+ */
+
+/**
+ * A collection of products that knows when it changed.
+ */
+class ProductCatalog {
+    vector<Product*> products;
+    uint64_t gen{0};
+
+public:
+    const vector<Product*> &items() const { return products; }
+    uint64_t generation() const { return gen; }
+
+    void add(Product *p) {
+        products.push_back(p);
+        ++gen;
+    }
+
+    void remove(const Product *p) {
+        auto it = find(products.begin(), products.end(), p);
+        if (it != products.end()) {
+            products.erase(it);
+            ++gen;
+        }
+    }
+
+    /**
+     * Call after changing a product in place.
+     */
+    void modified() { ++gen; }
+};
+
+struct QueryCacheStats {
+    size_t hits{0};
+    size_t misses{0};
+    size_t invalidations{0};
+    size_t evictions{0};
+    size_t uncacheable{0};
+    size_t entries{0};
+    size_t bytes{0};
+
+    double hit_rate() const {
+        auto lookups = hits + misses;
+        return lookups ? static_cast<double>(hits) / lookups : 0.0;
+    }
+
+    friend ostream &operator<<(ostream &os, const QueryCacheStats &s) {
+        return os << "hits " << s.hits << ", misses " << s.misses << " (" << s.invalidations << " stale)"
+                  << ", hit rate " << s.hit_rate() * 100 << "%"
+                  << ", uncacheable " << s.uncacheable
+                  << ", entries " << s.entries << ", evictions " << s.evictions
+                  << ", ~" << s.bytes / 1024 << " KiB";
+    }
+};
+
+class CachedFilter {
+public:
+    using Result = std::shared_ptr<const vector<Product*>>;
+
+private:
+    struct Entry {
+        string key;
+        uint64_t generation;
+        Result result;
+
+        size_t bytes() const {
+            // The key, the result vector, and roughly what the list node and hash node cost.
+            return sizeof(Entry) + key.capacity() + result->capacity() * sizeof(Product*) + 64;
+        }
+    };
+
+    BetterFilter inner;
+    const ProductCatalog &catalog;
+    size_t budget;
+
+    // Most recently used at the front.
+    list<Entry> lru;
+    unordered_map<string, list<Entry>::iterator> index;
+    QueryCacheStats counters;
+
+    static std::optional<string> canonical(const Specification<Product> &spec) {
+        if (auto c = dynamic_cast<const ColourSpecification*>(&spec))
+            return "c" + to_string(static_cast<int>(c->colour));
+        if (auto s = dynamic_cast<const SizeSpecification*>(&spec))
+            return "s" + to_string(static_cast<int>(s->size));
+
+        auto a = dynamic_cast<const AndSpecification<Product>*>(&spec);
+        auto o = dynamic_cast<const OrSpecification<Product>*>(&spec);
+        if (!a && !o)
+            return std::nullopt;
+
+        vector<string> operands;
+        if (!collect(spec, a ? "&" : "|", operands))
+            return std::nullopt;
+        sort(operands.begin(), operands.end());
+        operands.erase(unique(operands.begin(), operands.end()), operands.end());
+        if (operands.size() == 1)
+            return operands.front();
+
+        string key = a ? "&(" : "|(";
+        for (size_t i = 0; i < operands.size(); ++i)
+            key += (i ? "," : "") + operands[i];
+        return key + ")";
+    }
+
+    /**
+     * Gathers the operands of a run of the same operator, e.g. all the terms of a && b && c.
+     */
+    static bool collect(const Specification<Product> &spec, const string &op, vector<string> &operands) {
+        auto a = dynamic_cast<const AndSpecification<Product>*>(&spec);
+        auto o = dynamic_cast<const OrSpecification<Product>*>(&spec);
+        if ((op == "&" && a) || (op == "|" && o)) {
+            auto &s1 = a ? a->s1 : o->s1;
+            auto &s2 = a ? a->s2 : o->s2;
+            return collect(s1, op, operands) && collect(s2, op, operands);
+        }
+        auto key = canonical(spec);
+        if (!key)
+            return false;
+        operands.push_back(*key);
+        return true;
+    }
+
+    void evict_to_budget() {
+        while (counters.bytes > budget && lru.size() > 1) {
+            auto &victim = lru.back();
+            counters.bytes -= victim.bytes();
+            index.erase(victim.key);
+            lru.pop_back();
+            ++counters.evictions;
+        }
+        counters.entries = lru.size();
+    }
+
+public:
+    /**
+     * The catalog must outlive the cache. Results are only ever for this catalog: generations of different
+     * catalogs mean nothing to each other.
+     */
+    explicit CachedFilter(const ProductCatalog &catalog, size_t budget_bytes = 64 * 1024 * 1024)
+            : catalog(catalog), budget(budget_bytes) {}
+
+    Result filter(const Specification<Product> &spec) {
+        auto key = canonical(spec);
+        if (!key) {
+            ++counters.uncacheable;
+            return std::make_shared<const vector<Product*>>(inner.filter(catalog.items(), spec));
+        }
+
+        auto found = index.find(*key);
+        if (found != index.end()) {
+            auto entry = found->second;
+            lru.splice(lru.begin(), lru, entry);
+            if (entry->generation == catalog.generation()) {
+                ++counters.hits;
+                return entry->result;
+            }
+
+            ++counters.misses;
+            ++counters.invalidations;
+            counters.bytes -= entry->bytes();
+            entry->result = std::make_shared<const vector<Product*>>(inner.filter(catalog.items(), spec));
+            entry->generation = catalog.generation();
+            counters.bytes += entry->bytes();
+            evict_to_budget();
+            return entry->result;
+        }
+
+        ++counters.misses;
+        auto result = std::make_shared<const vector<Product*>>(inner.filter(catalog.items(), spec));
+        lru.push_front({*key, catalog.generation(), result});
+        index.emplace(*key, lru.begin());
+        counters.bytes += lru.front().bytes();
+        evict_to_budget();
+        return result;
+    }
+
+    /**
+     * Drops every entry, e.g. to give the memory back.
+     */
+    void clear() {
+        lru.clear();
+        index.clear();
+        counters.entries = 0;
+        counters.bytes = 0;
+    }
+
+    const QueryCacheStats &stats() const { return counters; }
+};
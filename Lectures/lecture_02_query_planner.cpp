@@ -0,0 +1,77 @@
+#include <random>
+
+#include "lecture_02_query_planner.h"
+#include "bench_util.h"
+
+/**
+ * A deliberately expensive specification, to give the planner something to move to the back.
+ */
+struct NameContainsSpecification : Specification<Product> {
+    const string fragment;
+
+    explicit NameContainsSpecification(string fragment) : fragment(std::move(fragment)) {}
+
+    bool is_satisfied(const Product * const item) const override {
+        return item->name.find(fragment) != string::npos;
+    }
+};
+
+/**
+ * Runs a badly ordered query as written and as planned, then explains the plan.
+ * Usage: lecture_02_query_planner [products]
+ */
+int main(int argc, char *argv[]) {
+    size_t n = argc > 1 ? stoul(argv[1]) : 2'000'000;
+    const string names[] = {"Oak tree", "Pine tree", "Beach house", "Town house", "Red car", "Cotton shirt"};
+
+    // Skewed catalog: only about 5% of products are red.
+    mt19937 rng{42};
+    vector<Product> products;
+    products.reserve(n);
+    for (size_t i = 0; i < n; ++i) {
+        auto roll = rng() % 100;
+        auto colour = roll < 5 ? Colour::red : roll < 55 ? Colour::green : Colour::blue;
+        products.push_back({names[rng() % 6], colour, static_cast<Size>(rng() % 3)});
+    }
+    vector<Product*> items;
+    for (auto &p: products)
+        items.push_back(&p);
+
+    // Written expensive-first: the name check, then size, then the rare colour.
+    NameContainsSpecification house{"house"};
+    SizeSpecification large{Size::large};
+    ColourSpecification red{Colour::red};
+    ColourSpecification green{Colour::green};
+    auto house_and_large = house && large;
+    auto written = house_and_large && red;
+    auto contradictory = written && green;
+
+    BetterFilter bf;
+    QueryPlanner planner;
+
+    auto start = chrono::steady_clock::now();
+    auto as_written = bf.filter(items, written);
+    auto written_time = seconds_since(start);
+
+    auto plan = planner.plan(items, written);
+    start = chrono::steady_clock::now();
+    auto as_planned = bf.filter(items, plan);
+    auto planned_time = seconds_since(start);
+
+    cout << n << " products, " << as_written.size() << " matches" << endl
+         << "  as written: " << written_time * 1e3 << " ms" << endl
+         << "  as planned: " << planned_time * 1e3 << " ms" << endl;
+    plan.explain(cout);
+
+    if (as_planned != as_written) {
+        cerr << "Mismatch between written and planned results" << endl;
+        return 1;
+    }
+
+    // Adding a second colour to the conjunction makes it unsatisfiable; the planner notices without scanning.
+    auto never = planner.plan(items, contradictory);
+    cout << "With && green: " << bf.filter(items, never).size() << " matches" << endl;
+    never.explain(cout);
+
+    return 0;
+}
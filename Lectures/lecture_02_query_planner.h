@@ -0,0 +1,299 @@
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <limits>
+
+#include "lecture_02_open_closed_principle_solution.h"
+
+/**
+ * QUERY PLANNER
+ *
+ * An AndSpecification chain is evaluated in the order the operators were written, so a cheap predicate that
+ * rejects almost everything may only run after several expensive ones that reject almost nothing.
+ *
+ * The planner samples the products, measures each leaf specification's selectivity (fraction of items that pass)
+ * and cost (time per call), and builds a QueryPlan:
+ * - nested && and || are flattened into n-ary all / any nodes;
+ * - duplicate leaves are dropped, and && of two different colours (or sizes) becomes a constant "never";
+ * - the children of an all node run in increasing cost / (1 - selectivity), so the cheapest way to reject comes
+ *   first, and the children of an any node in increasing cost / selectivity, so the cheapest way to accept comes
+ *   first.
+ *
+ * The plan is itself a Specification<Product>, so it is executed with the unchanged BetterFilter::filter.
+ * Every node counts how often it was evaluated and how often it passed; explain() prints the plan with those
+ * counts. The counters are not synchronized, so a plan should only be used by one thread at a time.
+ */
+
+inline const char *colour_name(Colour c) {
+    switch (c) {
+        case Colour::red: return "red";
+        case Colour::green: return "green";
+        case Colour::blue: return "blue";
+    }
+    return "?";
+}
+
+inline const char *size_name(Size s) {
+    switch (s) {
+        case Size::small: return "small";
+        case Size::medium: return "medium";
+        case Size::large: return "large";
+    }
+    return "?";
+}
+
+class QueryPlan : public Specification<Product> {
+    friend class QueryPlanner;
+
+public:
+    struct Node {
+        enum class Kind { leaf, all, any, never };
+
+        Kind kind{Kind::leaf};
+        const Specification<Product> *spec{nullptr};
+        vector<Node> children;
+
+        // Estimates from the sample: fraction of items that pass, and nanoseconds per evaluation.
+        double selectivity{1.0};
+        double cost{0.0};
+
+        // Observed while executing.
+        mutable size_t evaluations{0};
+        mutable size_t hits{0};
+
+        bool evaluate(const Product *item) const {
+            ++evaluations;
+            bool result = false;
+            switch (kind) {
+                case Kind::leaf:
+                    result = spec->is_satisfied(item);
+                    break;
+                case Kind::all:
+                    result = all_of(children.cbegin(), children.cend(), [item](auto &c) { return c.evaluate(item); });
+                    break;
+                case Kind::any:
+                    result = any_of(children.cbegin(), children.cend(), [item](auto &c) { return c.evaluate(item); });
+                    break;
+                case Kind::never:
+                    break;
+            }
+            hits += result;
+            return result;
+        }
+
+        void reset_counts() const {
+            evaluations = hits = 0;
+            for (auto &c: children)
+                c.reset_counts();
+        }
+    };
+
+    bool is_satisfied(const Product * const item) const override {
+        return root.evaluate(item);
+    }
+
+    const Node &root_node() const { return root; }
+
+    void reset_counts() const { root.reset_counts(); }
+
+    /**
+     * Prints the chosen plan: one line per node, with its estimates and the counts observed so far.
+     */
+    void explain(ostream &os) const {
+        explain(os, root, 0);
+    }
+
+private:
+    Node root;
+
+    static string describe(const Node &node) {
+        switch (node.kind) {
+            case Node::Kind::all: return "all";
+            case Node::Kind::any: return "any";
+            case Node::Kind::never: return "never";
+            case Node::Kind::leaf: break;
+        }
+        if (auto c = dynamic_cast<const ColourSpecification*>(node.spec))
+            return string("colour == ") + colour_name(c->colour);
+        if (auto s = dynamic_cast<const SizeSpecification*>(node.spec))
+            return string("size == ") + size_name(s->size);
+        return "custom specification";
+    }
+
+    static void explain(ostream &os, const Node &node, int depth) {
+        os << string(2 * depth, ' ') << describe(node)
+           << "  [est. selectivity " << node.selectivity << ", est. cost " << node.cost << " ns"
+           << ", evaluated " << node.evaluations << ", passed " << node.hits << "]" << endl;
+        for (auto &c: node.children)
+            explain(os, c, depth + 1);
+    }
+};
+
+class QueryPlanner {
+    using Node = QueryPlan::Node;
+
+    size_t sample_size;
+
+    /**
+     * Flattens the specification tree into all / any nodes with leaves, without any estimates yet.
+     */
+    static Node flatten(const Specification<Product> &spec) {
+        Node node;
+        if (auto a = dynamic_cast<const AndSpecification<Product>*>(&spec)) {
+            node.kind = Node::Kind::all;
+            absorb(node, flatten(a->s1));
+            absorb(node, flatten(a->s2));
+        } else if (auto o = dynamic_cast<const OrSpecification<Product>*>(&spec)) {
+            node.kind = Node::Kind::any;
+            absorb(node, flatten(o->s1));
+            absorb(node, flatten(o->s2));
+        } else {
+            node.spec = &spec;
+        }
+        return node;
+    }
+
+    static void absorb(Node &parent, Node child) {
+        if (child.kind == parent.kind)
+            for (auto &grandchild: child.children)
+                parent.children.push_back(std::move(grandchild));
+        else
+            parent.children.push_back(std::move(child));
+    }
+
+    static bool same_leaf(const Node &a, const Node &b) {
+        if (a.kind != Node::Kind::leaf || b.kind != Node::Kind::leaf)
+            return false;
+        if (a.spec == b.spec)
+            return true;
+        auto ca = dynamic_cast<const ColourSpecification*>(a.spec);
+        auto cb = dynamic_cast<const ColourSpecification*>(b.spec);
+        if (ca && cb)
+            return ca->colour == cb->colour;
+        auto sa = dynamic_cast<const SizeSpecification*>(a.spec);
+        auto sb = dynamic_cast<const SizeSpecification*>(b.spec);
+        return sa && sb && sa->size == sb->size;
+    }
+
+    /**
+     * A product has exactly one colour and one size, so requiring two different ones can never pass.
+     */
+    static bool contradicts(const Node &a, const Node &b) {
+        if (a.kind != Node::Kind::leaf || b.kind != Node::Kind::leaf)
+            return false;
+        auto ca = dynamic_cast<const ColourSpecification*>(a.spec);
+        auto cb = dynamic_cast<const ColourSpecification*>(b.spec);
+        if (ca && cb)
+            return ca->colour != cb->colour;
+        auto sa = dynamic_cast<const SizeSpecification*>(a.spec);
+        auto sb = dynamic_cast<const SizeSpecification*>(b.spec);
+        return sa && sb && sa->size != sb->size;
+    }
+
+    static void simplify(Node &node) {
+        if (node.kind == Node::Kind::leaf || node.kind == Node::Kind::never)
+            return;
+        for (auto &c: node.children)
+            simplify(c);
+
+        vector<Node> kept;
+        for (auto &c: node.children) {
+            if (any_of(kept.cbegin(), kept.cend(), [&c](auto &k) { return same_leaf(k, c); }))
+                continue;
+            kept.push_back(std::move(c));
+        }
+        node.children = std::move(kept);
+
+        auto is_never = [](auto &c) { return c.kind == Node::Kind::never; };
+        if (node.kind == Node::Kind::all) {
+            bool never = any_of(node.children.cbegin(), node.children.cend(), is_never);
+            for (size_t i = 0; i < node.children.size() && !never; ++i)
+                for (size_t j = i + 1; j < node.children.size() && !never; ++j)
+                    never = contradicts(node.children[i], node.children[j]);
+            if (never) {
+                node = Node{};
+                node.kind = Node::Kind::never;
+                return;
+            }
+        } else {
+            node.children.erase(remove_if(node.children.begin(), node.children.end(), is_never),
+                                node.children.end());
+            if (node.children.empty()) {
+                node.kind = Node::Kind::never;
+                return;
+            }
+        }
+
+        if (node.children.size() == 1) {
+            Node only = std::move(node.children.front());
+            node = std::move(only);
+        }
+    }
+
+    /**
+     * Fills in selectivity and cost bottom-up, ordering children as it goes.
+     * Children are assumed independent when combining their estimates.
+     */
+    static void estimate(Node &node, const vector<Product*> &sample) {
+        switch (node.kind) {
+            case Node::Kind::never:
+                node.selectivity = 0.0;
+                node.cost = 0.0;
+                return;
+
+            case Node::Kind::leaf: {
+                size_t passed = 0;
+                auto start = chrono::steady_clock::now();
+                for (auto p: sample)
+                    passed += node.spec->is_satisfied(p);
+                auto elapsed = chrono::duration<double, nano>(chrono::steady_clock::now() - start).count();
+                node.selectivity = sample.empty() ? 1.0 : static_cast<double>(passed) / sample.size();
+                node.cost = sample.empty() ? 1.0 : max(elapsed / sample.size(), 0.1);
+                return;
+            }
+
+            case Node::Kind::all:
+            case Node::Kind::any:
+                break;
+        }
+
+        for (auto &c: node.children)
+            estimate(c, sample);
+
+        bool all = node.kind == Node::Kind::all;
+        auto rank = [all](const Node &n) {
+            // Probability that this child decides the node's result.
+            double decides = all ? 1.0 - n.selectivity : n.selectivity;
+            return decides > 0.0 ? n.cost / decides : numeric_limits<double>::infinity();
+        };
+        stable_sort(node.children.begin(), node.children.end(),
+                    [&rank](const Node &a, const Node &b) { return rank(a) < rank(b); });
+
+        // Expected cost of evaluating the children in this order with short-circuiting.
+        double reach = 1.0, cost = 0.0;
+        for (auto &c: node.children) {
+            cost += reach * c.cost;
+            reach *= all ? c.selectivity : 1.0 - c.selectivity;
+        }
+        node.cost = cost;
+        node.selectivity = all ? reach : 1.0 - reach;
+    }
+
+public:
+    explicit QueryPlanner(size_t sample_size = 1024) : sample_size(sample_size) {}
+
+    QueryPlan plan(const vector<Product*> &items, const Specification<Product> &spec) const {
+        // Evenly strided sample, so the plan does not depend on a random seed.
+        vector<Product*> sample;
+        size_t stride = max<size_t>(1, items.size() / max<size_t>(1, sample_size));
+        for (size_t i = 0; i < items.size() && sample.size() < sample_size; i += stride)
+            sample.push_back(items[i]);
+
+        QueryPlan plan;
+        plan.root = flatten(spec);
+        simplify(plan.root);
+        estimate(plan.root, sample);
+        return plan;
+    }
+};
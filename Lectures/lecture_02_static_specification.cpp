@@ -0,0 +1,68 @@
+#include <chrono>
+#include <random>
+
+#include "lecture_02_static_specification.h"
+#include "bench_util.h"
+
+/**
+ * Compares a five-term specification built at runtime out of AndSpecification / OrSpecification
+ * with the same specification composed at compile time.
+ * Usage: lecture_02_static_specification [products]
+ */
+int main(int argc, char *argv[]) {
+    size_t n = argc > 1 ? stoul(argv[1]) : 4'000'000;
+
+    mt19937 rng{42};
+    vector<Product> products;
+    products.reserve(n);
+    for (size_t i = 0; i < n; ++i)
+        products.push_back({"Item", static_cast<Colour>(rng() % 3), static_cast<Size>(rng() % 3)});
+
+    vector<Product*> items;
+    items.reserve(n);
+    for (auto &p: products)
+        items.push_back(&p);
+
+    // green || (blue && large) || (red && small), built at runtime.
+    ColourSpecification green{Colour::green};
+    ColourSpecification blue{Colour::blue};
+    ColourSpecification red{Colour::red};
+    SizeSpecification large{Size::large};
+    SizeSpecification small{Size::small};
+    auto blue_and_large = blue && large;
+    auto red_and_small = red && small;
+    auto green_or_blue_large = green || blue_and_large;
+    auto dynamic_spec = green_or_blue_large || red_and_small;
+
+    // The same query, composed at compile time.
+    auto static_query = static_spec(ColourSpecification{Colour::green})
+            || (static_spec(ColourSpecification{Colour::blue}) && SizeSpecification{Size::large})
+            || (static_spec(ColourSpecification{Colour::red}) && SizeSpecification{Size::small});
+
+    BetterFilter bf;
+
+    auto start = chrono::steady_clock::now();
+    auto dynamic_result = bf.filter(items, dynamic_spec);
+    auto dynamic_time = seconds_since(start);
+
+    start = chrono::steady_clock::now();
+    auto static_result = bf.filter(items, static_query);
+    auto static_time = seconds_since(start);
+
+    start = chrono::steady_clock::now();
+    vector<Product*> copy_if_result;
+    copy_if(items.cbegin(), items.cend(), back_inserter(copy_if_result), static_query);
+    auto copy_if_time = seconds_since(start);
+
+    cout << n << " products, " << dynamic_result.size() << " matches" << endl
+         << "  virtual dispatch:   " << n / dynamic_time / 1e6 << " M products/s" << endl
+         << "  static expression:  " << n / static_time / 1e6 << " M products/s" << endl
+         << "  std::copy_if:       " << n / copy_if_time / 1e6 << " M products/s" << endl;
+
+    if (static_result != dynamic_result || copy_if_result != dynamic_result) {
+        cerr << "Mismatch between dynamic and static results" << endl;
+        return 1;
+    }
+
+    return 0;
+}
@@ -0,0 +1,110 @@
+#pragma once
+
+#include <type_traits>
+
+#include "lecture_02_open_closed_principle_solution.h"
+
+/**
+ * STATIC SPECIFICATIONS: EXPRESSION TEMPLATES
+ *
+ * AndSpecification and OrSpecification hold references to Specification<T> bases, so every node of a composite
+ * specification is an indirect call, and a five-term specification costs five or more virtual calls per item.
+ *
+ * When the shape of the query is known at compile time, we can instead build the tree out of types:
+ * static_spec(ColourSpecification{Colour::green}) && SizeSpecification{Size::large} has type
+ *     SpecAnd<SpecLeaf<ColourSpecification>, SpecLeaf<SizeSpecification>>
+ * and evaluating it is a chain of non-virtual calls that the compiler can inline into a single predicate.
+ *
+ * Expressions hold their parts by value, so they are safe to build from temporaries.
+ * The runtime-polymorphic Specification<T> path is untouched and is still what dynamically built queries use.
+ */
+
+/**
+ * CRTP base of all static specification expressions.
+ */
+template <typename Derived> struct SpecExpr {
+    const Derived &derived() const {
+        return static_cast<const Derived&>(*this);
+    }
+
+    template <typename T> bool is_satisfied(const T* const item) const {
+        return derived()(item);
+    }
+};
+
+/**
+ * Wraps a concrete specification. The qualified call S::is_satisfied bypasses the vtable.
+ */
+template <typename S> struct SpecLeaf : SpecExpr<SpecLeaf<S>> {
+    S spec;
+
+    explicit SpecLeaf(S spec) : spec(std::move(spec)) {}
+
+    template <typename T> bool operator()(const T* const item) const {
+        return spec.S::is_satisfied(item);
+    }
+};
+
+template <typename L, typename R> struct SpecAnd : SpecExpr<SpecAnd<L, R>> {
+    L lhs;
+    R rhs;
+
+    SpecAnd(L lhs, R rhs) : lhs(std::move(lhs)), rhs(std::move(rhs)) {}
+
+    template <typename T> bool operator()(const T* const item) const {
+        return lhs(item) && rhs(item);
+    }
+};
+
+template <typename L, typename R> struct SpecOr : SpecExpr<SpecOr<L, R>> {
+    L lhs;
+    R rhs;
+
+    SpecOr(L lhs, R rhs) : lhs(std::move(lhs)), rhs(std::move(rhs)) {}
+
+    template <typename T> bool operator()(const T* const item) const {
+        return lhs(item) || rhs(item);
+    }
+};
+
+/**
+ * Entry point into the compile-time composition mode.
+ */
+template <typename S> SpecLeaf<S> static_spec(S spec) {
+    return SpecLeaf<S>{std::move(spec)};
+}
+
+template <typename S> constexpr bool is_spec_expr_v = std::is_base_of_v<SpecExpr<S>, S>;
+
+/**
+ * Turns a concrete specification into a leaf, and leaves expressions as they are.
+ */
+template <typename S, typename = std::enable_if_t<!is_spec_expr_v<S>>>
+SpecLeaf<S> as_spec_expr(const S &spec) { return SpecLeaf<S>{spec}; }
+
+template <typename E> const E &as_spec_expr(const SpecExpr<E> &expr) { return expr.derived(); }
+
+template <typename S> using spec_expr_t = std::decay_t<decltype(as_spec_expr(std::declval<const S&>()))>;
+
+/**
+ * The operators are only picked up if at least one side is already an expression, so plain
+ * ColourSpecification && SizeSpecification still builds an AndSpecification as before.
+ */
+template <typename L, typename R,
+          typename = std::enable_if_t<is_spec_expr_v<std::decay_t<L>> || is_spec_expr_v<std::decay_t<R>>>>
+SpecAnd<spec_expr_t<L>, spec_expr_t<R>> operator&&(const L &lhs, const R &rhs) {
+    return {as_spec_expr(lhs), as_spec_expr(rhs)};
+}
+
+template <typename L, typename R,
+          typename = std::enable_if_t<is_spec_expr_v<std::decay_t<L>> || is_spec_expr_v<std::decay_t<R>>>>
+SpecOr<spec_expr_t<L>, spec_expr_t<R>> operator||(const L &lhs, const R &rhs) {
+    return {as_spec_expr(lhs), as_spec_expr(rhs)};
+}
+
+template <typename E>
+vector<Product*> BetterFilter::filter(const vector<Product*> &items, const SpecExpr<E> &spec) {
+    vector<Product*> result;
+    copy_if(items.cbegin(), items.cend(), back_inserter(result), spec.derived());
+    return result;
+}
@@ -0,0 +1,81 @@
+#include <chrono>
+#include <random>
+
+#include "lecture_05_indexed_relationships.h"
+#include "bench_util.h"
+
+/**
+ * A high-level module that researches many people at once, written against the batch abstraction.
+ * It only sees ids and string_views, and reuses one ChildrenBatch for every round.
+ */
+struct BatchResearch {
+    const BatchRelationshipBrowser &browser;
+    ChildrenBatch batch;
+
+    explicit BatchResearch(const BatchRelationshipBrowser &browser) : browser(browser) {}
+
+    /**
+     * Total length of the names of all the children of the given people.
+     */
+    size_t children_name_length(const vector<string_view> &names) {
+        browser.findAllChildrenOf(names, batch);
+        size_t total = 0;
+        for (auto &span: batch.spans)
+            for (auto child: span)
+                total += browser.name_view(child).size();
+        return total;
+    }
+};
+
+/**
+ * Compares the per-name findAllChildrenOf, which copies each child into a Person, with the batch lookup.
+ * Usage: lecture_05_batch_relationships [parents] [children per parent] [batch size] [batches]
+ */
+int main(int argc, char *argv[]) {
+    size_t parents = argc > 1 ? stoul(argv[1]) : 200'000;
+    size_t per_parent = argc > 2 ? stoul(argv[2]) : 3;
+    size_t batch_size = argc > 3 ? stoul(argv[3]) : 4'096;
+    size_t batches = argc > 4 ? stoul(argv[4]) : 200;
+
+    IndexedRelationships relationships;
+    for (size_t p = 0; p < parents; ++p) {
+        Person parent{"Parent" + to_string(p)};
+        for (size_t c = 0; c < per_parent; ++c)
+            relationships.add_parent_and_child(parent, Person{"Child" + to_string(p) + "_" + to_string(c)});
+    }
+
+    mt19937 rng{42};
+    vector<string> storage;
+    for (size_t i = 0; i < batch_size; ++i)
+        storage.push_back("Parent" + to_string(rng() % parents));
+    vector<string_view> names(storage.begin(), storage.end());
+
+    size_t per_name_total = 0;
+    auto start = chrono::steady_clock::now();
+    for (size_t b = 0; b < batches; ++b) {
+        per_name_total = 0;
+        for (auto &name: storage)
+            for (auto &child: relationships.findAllChildrenOf(name))
+                per_name_total += child.name.size();
+    }
+    auto per_name_time = seconds_since(start);
+
+    BatchResearch research{relationships};
+    size_t batch_total = 0;
+    start = chrono::steady_clock::now();
+    for (size_t b = 0; b < batches; ++b)
+        batch_total = research.children_name_length(names);
+    auto batch_time = seconds_since(start);
+
+    auto lookups = static_cast<double>(batch_size * batches);
+    cout << relationships.person_count() << " people, " << batches << " batches of " << batch_size << " names" << endl
+         << "  per-name findAllChildrenOf: " << lookups / per_name_time / 1e6 << " M lookups/s" << endl
+         << "  batch findAllChildrenOf:    " << lookups / batch_time / 1e6 << " M lookups/s" << endl;
+
+    if (per_name_total != batch_total) {
+        cerr << "Mismatch: " << per_name_total << " vs " << batch_total << endl;
+        return 1;
+    }
+
+    return 0;
+}
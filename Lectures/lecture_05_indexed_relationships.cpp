@@ -0,0 +1,77 @@
+#include <chrono>
+#include <random>
+
+#include "lecture_05_indexed_relationships.h"
+#include "bench_util.h"
+
+/**
+ * Research works unchanged against the indexed browser; then both browsers answer the same random lookups.
+ * Usage: lecture_05_indexed_relationships [parents] [children per parent] [queries]
+ */
+int main(int argc, char *argv[]) {
+    Person parent{"John"};
+    Person child1{"Chris"};
+    Person child2{"Matt"};
+
+    IndexedRelationships indexed;
+    indexed.add_parent_and_child(parent, child1);
+    indexed.add_parent_and_child(parent, child2);
+    Research research{indexed};
+
+    size_t parents = argc > 1 ? stoul(argv[1]) : 50'000;
+    size_t per_parent = argc > 2 ? stoul(argv[2]) : 2;
+    size_t queries = argc > 3 ? stoul(argv[3]) : 200;
+
+    Relationships scanned;
+    IndexedRelationships large;
+    for (size_t p = 0; p < parents; ++p) {
+        Person parent{"Parent" + to_string(p)};
+        for (size_t c = 0; c < per_parent; ++c) {
+            Person child{"Child" + to_string(p) + "_" + to_string(c)};
+            scanned.add_parent_and_child(parent, child);
+            large.add_parent_and_child(parent, child);
+        }
+    }
+
+    mt19937 rng{42};
+    vector<string> lookups;
+    for (size_t q = 0; q < queries; ++q)
+        lookups.push_back("Parent" + to_string(rng() % parents));
+
+    size_t scanned_found = 0, indexed_found = 0;
+    auto start = chrono::steady_clock::now();
+    for (auto &name: lookups)
+        scanned_found += scanned.findAllChildrenOf(name).size();
+    auto scanned_time = seconds_since(start);
+
+    start = chrono::steady_clock::now();
+    for (auto &name: lookups)
+        indexed_found += large.findAllChildrenOf(name).size();
+    auto indexed_time = seconds_since(start);
+
+    cout << scanned.relations.size() << " relations, " << queries << " lookups" << endl
+         << "  Relationships:        " << queries / scanned_time << " lookups/s" << endl
+         << "  IndexedRelationships: " << queries / indexed_time << " lookups/s" << endl;
+
+    if (scanned_found != indexed_found) {
+        cerr << "Mismatch: " << scanned_found << " vs " << indexed_found << " children found" << endl;
+        return 1;
+    }
+
+    // A copy looks names up in its own strings, so it keeps working once the store it was copied from is gone.
+    auto copy = [&] {
+        IndexedRelationships original;
+        original.add_parent_and_child(parent, child1);
+        original.add_parent_and_child(parent, child2);
+        IndexedRelationships copied{original};
+        return copied;
+    }();
+    copy.add_parent_and_child(parent, Person{"Jane"});
+    if (copy.find("Chris") != indexed.find("Chris") || copy.person_count() != 4
+        || copy.findAllChildrenOf("John").size() != 3 || indexed.findAllChildrenOf("John").size() != 2) {
+        cerr << "A copy of IndexedRelationships does not find its own people" << endl;
+        return 1;
+    }
+
+    return 0;
+}
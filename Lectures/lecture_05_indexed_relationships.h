@@ -0,0 +1,178 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <deque>
+#include <string_view>
+#include <unordered_map>
+
+#include "lecture_05_dependency_inversion_principle_solution.h"
+
+/**
+ * INDEXED RELATIONSHIPS
+ *
+ * Relationships answers findAllChildrenOf by scanning every (Person, Relationship, Person) tuple and comparing
+ * names, so each query costs O(relations) string compares, and every tuple holds two full copies of a Person.
+ *
+ * IndexedRelationships is another low-level module behind the same RelationshipBrowser abstraction, so Research
+ * does not change. It interns each name once and refers to people by integer id, and keeps for every person one
+ * adjacency list per kind of relationship. Looking a name up is one hash probe, and the children are then read
+ * straight out of the list: O(children).
+ */
+using PersonId = uint32_t;
+
+/**
+ * A view of ids stored somewhere else. Valid until the store it points into changes.
+ */
+struct IdSpan {
+    const PersonId *first{nullptr};
+    size_t count{0};
+
+    const PersonId *begin() const { return first; }
+    const PersonId *end() const { return first + count; }
+    size_t size() const { return count; }
+    bool empty() const { return count == 0; }
+};
+
+/**
+ * The answers to a batch of lookups: spans[i] are the children of the i-th name asked for.
+ * Keep one around and pass it to every batch, so its storage is reused instead of reallocated.
+ */
+struct ChildrenBatch {
+    vector<IdSpan> spans;
+};
+
+/**
+ * Abstraction for high-level modules that look up many people at once.
+ * Results are ids and string_views into the store rather than copied Person objects.
+ */
+struct BatchRelationshipBrowser {
+    virtual void findAllChildrenOf(const vector<string_view> &names, ChildrenBatch &out) const = 0;
+    virtual string_view name_view(PersonId id) const = 0;
+};
+
+class IndexedRelationships : public RelationshipBrowser, public BatchRelationshipBrowser {
+    static constexpr size_t relationship_kinds = 3;
+    using Adjacency = std::array<vector<PersonId>, relationship_kinds>;
+
+    // deque, so the strings never move and the string_view keys below stay valid.
+    deque<string> names;
+    unordered_map<string_view, PersonId> ids;
+    vector<Adjacency> adjacency;
+
+    void link(PersonId from, Relationship rel, PersonId to) {
+        adjacency[from][static_cast<size_t>(rel)].push_back(to);
+    }
+
+    // Points ids at this store's own names.
+    void index_names() {
+        ids.clear();
+        ids.reserve(names.size());
+        for (PersonId id = 0; id < names.size(); ++id)
+            ids.emplace(names[id], id);
+    }
+
+public:
+    static constexpr PersonId no_person = ~PersonId{0};
+
+    IndexedRelationships() = default;
+
+    // A copy has names of its own, so its ids are rebuilt: copied ones would still view the other store's strings.
+    // Moving keeps the strings where they are, views and all.
+    IndexedRelationships(const IndexedRelationships &other) : names(other.names), adjacency(other.adjacency) {
+        index_names();
+    }
+
+    IndexedRelationships(IndexedRelationships &&) = default;
+
+    IndexedRelationships &operator=(const IndexedRelationships &other) {
+        if (this != &other) {
+            names = other.names;
+            adjacency = other.adjacency;
+            index_names();
+        }
+        return *this;
+    }
+
+    IndexedRelationships &operator=(IndexedRelationships &&) = default;
+
+    /**
+     * The id for a name, adding the person if they are not known yet.
+     */
+    PersonId intern(const string &name) {
+        auto it = ids.find(name);
+        if (it != ids.end())
+            return it->second;
+
+        auto id = static_cast<PersonId>(names.size());
+        names.push_back(name);
+        ids.emplace(names.back(), id);
+        adjacency.emplace_back();
+        return id;
+    }
+
+    /**
+     * The id for a name, or no_person if nobody of that name was added.
+     */
+    PersonId find(string_view name) const {
+        auto it = ids.find(name);
+        return it == ids.end() ? no_person : it->second;
+    }
+
+    const string &name_of(PersonId id) const { return names[id]; }
+
+    size_t person_count() const { return names.size(); }
+
+    void add_parent_and_child(const Person &parent, const Person &child) {
+        auto p = intern(parent.name);
+        auto c = intern(child.name);
+        link(p, Relationship::parent, c);
+        link(c, Relationship::child, p);
+    }
+
+    void add_siblings(const Person &first, const Person &second) {
+        auto a = intern(first.name);
+        auto b = intern(second.name);
+        link(a, Relationship::sibling, b);
+        link(b, Relationship::sibling, a);
+    }
+
+    /**
+     * Everyone id stands in relationship rel to, e.g. related(john, Relationship::parent) are John's children.
+     */
+    const vector<PersonId> &related(PersonId id, Relationship rel) const {
+        return adjacency[id][static_cast<size_t>(rel)];
+    }
+
+    /**
+     * Batch lookup: one hash probe per name, no allocation once out has grown to the batch size.
+     * Unknown names get an empty span.
+     */
+    void findAllChildrenOf(const vector<string_view> &lookups, ChildrenBatch &out) const override {
+        out.spans.resize(lookups.size());
+        for (size_t i = 0; i < lookups.size(); ++i) {
+            auto id = find(lookups[i]);
+            if (id == no_person) {
+                out.spans[i] = {};
+            } else {
+                auto &children = related(id, Relationship::parent);
+                out.spans[i] = {children.data(), children.size()};
+            }
+        }
+    }
+
+    string_view name_view(PersonId id) const override { return names[id]; }
+
+    vector<Person> findAllChildrenOf(const string &name) override {
+        vector<Person> result;
+        auto id = find(name);
+        if (id == no_person)
+            return result;
+
+        auto &children = related(id, Relationship::parent);
+        result.reserve(children.size());
+        for (auto c: children)
+            result.push_back({names[c]});
+        return result;
+    }
+};
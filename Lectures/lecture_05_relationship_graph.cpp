@@ -0,0 +1,96 @@
+#include <chrono>
+#include <random>
+
+#include "lecture_05_relationship_graph.h"
+#include "bench_util.h"
+
+/**
+ * Generates a genealogy with the given number of parent -> child edges: everyone after the first generation has
+ * two distinct parents, picked from the people born shortly before them.
+ */
+RelationshipGraph generate_genealogy(size_t edge_count, size_t window = 1024) {
+    size_t founders = window;
+    size_t people = founders + edge_count / 2;
+
+    mt19937_64 rng{42};
+    vector<pair<PersonId, PersonId>> edges;
+    edges.reserve(edge_count);
+    for (size_t child = founders; child < people; ++child) {
+        auto first = static_cast<PersonId>(child - 1 - rng() % window);
+        auto second = static_cast<PersonId>(child - 1 - rng() % window);
+        if (second == first)
+            second = first == child - 1 ? first - 1 : first + 1;
+        edges.emplace_back(first, static_cast<PersonId>(child));
+        edges.emplace_back(second, static_cast<PersonId>(child));
+    }
+    return {people, edges};
+}
+
+/**
+ * Research on the small family, through the CSR snapshot, then traversal timings on generated genealogies.
+ * Usage: lecture_05_relationship_graph [edge counts...]   (default: 1000000 10000000; try 100000000 too)
+ */
+int main(int argc, char *argv[]) {
+    Person john{"John"}, chris{"Chris"}, matt{"Matt"}, amy{"Amy"};
+    Relationships relationships;
+    relationships.add_parent_and_child(john, chris);
+    relationships.add_parent_and_child(john, matt);
+    relationships.add_parent_and_child(chris, amy);
+
+    auto family = RelationshipGraph::from(relationships);
+    for (auto d: family.findAllDescendantsOf(family.find("John")))
+        cout << "John is an ancestor of " << family.name_of(d) << endl;
+    for (auto a: family.findCommonAncestors(family.find("Amy"), family.find("Matt")))
+        cout << "Amy and Matt share the ancestor " << family.name_of(a) << endl;
+
+    auto nobody = family.find("Nobody");
+    if (!family.findAllDescendantsOf(nobody).empty() || !family.findAllAncestorsOf(nobody).empty() ||
+        !family.findAllSiblingsOf(nobody).empty() || !family.findCommonAncestors(nobody, family.find("Amy")).empty()) {
+        cerr << "Found relatives of someone who does not exist" << endl;
+        return 1;
+    }
+
+    vector<size_t> sizes;
+    for (int i = 1; i < argc; ++i)
+        sizes.push_back(stoull(argv[i]));
+    if (sizes.empty())
+        sizes = {1'000'000, 10'000'000};
+
+    WorkerPool pool;
+    for (auto edges: sizes) {
+        auto start = chrono::steady_clock::now();
+        auto graph = generate_genealogy(edges);
+        auto build_time = seconds_since(start);
+
+        // Someone a tenth of the way in, whose descendants cover most of the later generations.
+        PersonId ancestor = graph.person_count() / 10;
+        start = chrono::steady_clock::now();
+        auto sequential = graph.findAllDescendantsOf(ancestor);
+        auto sequential_time = seconds_since(start);
+
+        start = chrono::steady_clock::now();
+        auto parallel = graph.findAllDescendantsOf(ancestor, &pool);
+        auto parallel_time = seconds_since(start);
+
+        PersonId last = graph.person_count() - 1;
+        start = chrono::steady_clock::now();
+        auto common = graph.findCommonAncestors(last, last - 1, &pool);
+        auto common_time = seconds_since(start);
+
+        cout << graph.edge_count() << " edges, " << graph.person_count() << " people"
+             << " (generated and built in " << build_time << " s)" << endl
+             << "  descendants of person " << ancestor << ": " << sequential.size() << endl
+             << "    sequential BFS:   " << graph.edge_count() / sequential_time / 1e6 << " M edges/s" << endl
+             << "    parallel BFS x" << pool.size() << ": "
+             << graph.edge_count() / parallel_time / 1e6 << " M edges/s" << endl
+             << "  common ancestors of the two youngest: " << common.size()
+             << " in " << common_time * 1e3 << " ms" << endl;
+
+        if (sequential != parallel) {
+            cerr << "Mismatch between sequential and parallel BFS" << endl;
+            return 1;
+        }
+    }
+
+    return 0;
+}
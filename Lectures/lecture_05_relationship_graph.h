@@ -0,0 +1,207 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+
+#include "lecture_05_indexed_relationships.h"
+#include "worker_pool.h"
+
+/**
+ * CSR RELATIONSHIP GRAPH
+ *
+ * Genealogy research asks for whole closures (all descendants, all ancestors, the ancestors two people share)
+ * over graphs with tens of millions of parent / child edges. Walking adjacency lists of separately allocated
+ * vectors is too scattered for that, so RelationshipGraph is an immutable snapshot in compressed sparse row form:
+ * for each direction, one array of all neighbour ids, grouped by person, and one array of offsets into it.
+ * The neighbours of person i are targets[offsets[i]] .. targets[offsets[i + 1]].
+ *
+ * Closures are computed with level-synchronous BFS. Each level's frontier is cut into chunks that run on a
+ * WorkerPool; a person is claimed by atomically setting its bit in a visited bitmap, so each one is added to the
+ * next frontier exactly once. Small frontiers are expanded on the calling thread.
+ * The order of people within a level depends on scheduling, so the results are returned sorted by id.
+ */
+class RelationshipGraph {
+    struct Csr {
+        vector<uint64_t> offsets;
+        vector<PersonId> targets;
+
+        const PersonId *begin(PersonId p) const { return targets.data() + offsets[p]; }
+        const PersonId *end(PersonId p) const { return targets.data() + offsets[p + 1]; }
+    };
+
+    size_t people{0};
+    Csr children;  // parent -> child
+    Csr parents;   // child -> parent
+
+    vector<string> names;
+    unordered_map<string, PersonId> ids;
+
+    static Csr build(size_t people, const vector<pair<PersonId, PersonId>> &edges, bool reverse) {
+        Csr csr;
+        csr.offsets.assign(people + 1, 0);
+        for (auto &[from, to]: edges)
+            ++csr.offsets[(reverse ? to : from) + 1];
+        for (size_t i = 0; i < people; ++i)
+            csr.offsets[i + 1] += csr.offsets[i];
+
+        csr.targets.resize(edges.size());
+        vector<uint64_t> fill(csr.offsets.begin(), csr.offsets.end() - 1);
+        for (auto &[from, to]: edges) {
+            auto source = reverse ? to : from;
+            csr.targets[fill[source]++] = reverse ? from : to;
+        }
+        return csr;
+    }
+
+    class Visited {
+        vector<atomic<uint64_t>> bits;
+
+    public:
+        explicit Visited(size_t people) : bits((people + 63) / 64) {}
+
+        /**
+         * True for exactly one caller per person.
+         */
+        bool claim(PersonId p) {
+            uint64_t mask = uint64_t{1} << (p % 64);
+            auto &word = bits[p / 64];
+            if (word.load(memory_order_relaxed) & mask)
+                return false;
+            return !(word.fetch_or(mask, memory_order_relaxed) & mask);
+        }
+    };
+
+    /**
+     * Everyone reachable from start along csr, not including start itself, sorted by id. Nobody, for an id that
+     * is not a person, such as no_person.
+     */
+    vector<PersonId> closure(PersonId start, const Csr &csr, WorkerPool *pool) const {
+        const size_t chunk_size = 4096;
+        if (start >= people)
+            return {};
+
+        Visited visited{people};
+        vector<PersonId> result;
+        vector<PersonId> frontier{start};
+        visited.claim(start);
+
+        while (!frontier.empty()) {
+            vector<PersonId> next;
+            if (!pool || pool->size() == 1 || frontier.size() < 2 * chunk_size) {
+                for (auto p: frontier)
+                    for (auto q = csr.begin(p); q != csr.end(p); ++q)
+                        if (visited.claim(*q))
+                            next.push_back(*q);
+            } else {
+                size_t chunks = (frontier.size() + chunk_size - 1) / chunk_size;
+                vector<vector<PersonId>> found(chunks);
+                pool->parallel_for(chunks, [&](size_t c) {
+                    auto first = frontier.begin() + c * chunk_size;
+                    auto last = frontier.begin() + min(frontier.size(), (c + 1) * chunk_size);
+                    for (auto it = first; it != last; ++it)
+                        for (auto q = csr.begin(*it); q != csr.end(*it); ++q)
+                            if (visited.claim(*q))
+                                found[c].push_back(*q);
+                });
+                size_t total = 0;
+                for (auto &f: found)
+                    total += f.size();
+                next.reserve(total);
+                for (auto &f: found)
+                    next.insert(next.end(), f.begin(), f.end());
+            }
+
+            result.insert(result.end(), next.begin(), next.end());
+            frontier.swap(next);
+        }
+
+        sort(result.begin(), result.end());
+        return result;
+    }
+
+public:
+    /**
+     * Builds the snapshot from parent -> child edges between people numbered 0 .. people - 1.
+     * Names are optional; without them, people are only known by id.
+     */
+    RelationshipGraph(size_t people, const vector<pair<PersonId, PersonId>> &parent_child,
+                      vector<string> person_names = {})
+            : people(people), children(build(people, parent_child, false)),
+              parents(build(people, parent_child, true)), names(std::move(person_names)) {
+        for (size_t i = 0; i < names.size(); ++i)
+            ids.emplace(names[i], static_cast<PersonId>(i));
+    }
+
+    static RelationshipGraph from(const Relationships &relationships) {
+        IndexedRelationships interned;
+        vector<pair<PersonId, PersonId>> edges;
+        for (auto &&[first, rel, second]: relationships.relations) {
+            if (rel == Relationship::parent)
+                edges.emplace_back(interned.intern(first.name), interned.intern(second.name));
+        }
+        return from_interned(interned, edges);
+    }
+
+    static RelationshipGraph from(const IndexedRelationships &relationships) {
+        vector<pair<PersonId, PersonId>> edges;
+        for (PersonId p = 0; p < relationships.person_count(); ++p)
+            for (auto c: relationships.related(p, Relationship::parent))
+                edges.emplace_back(p, c);
+        return from_interned(relationships, edges);
+    }
+
+    size_t person_count() const { return people; }
+    size_t edge_count() const { return children.targets.size(); }
+
+    /**
+     * The id for a name, or no_person if there is nobody of that name. Queries for no_person find nobody.
+     */
+    PersonId find(const string &name) const {
+        auto it = ids.find(name);
+        return it == ids.end() ? IndexedRelationships::no_person : it->second;
+    }
+
+    const string &name_of(PersonId id) const { return names[id]; }
+
+    vector<PersonId> findAllDescendantsOf(PersonId id, WorkerPool *pool = nullptr) const {
+        return closure(id, children, pool);
+    }
+
+    vector<PersonId> findAllAncestorsOf(PersonId id, WorkerPool *pool = nullptr) const {
+        return closure(id, parents, pool);
+    }
+
+    /**
+     * Everyone who shares at least one parent with id, not including id.
+     */
+    vector<PersonId> findAllSiblingsOf(PersonId id) const {
+        vector<PersonId> result;
+        if (id >= people)
+            return result;
+        for (auto p = parents.begin(id); p != parents.end(id); ++p)
+            for (auto c = children.begin(*p); c != children.end(*p); ++c)
+                if (*c != id)
+                    result.push_back(*c);
+        sort(result.begin(), result.end());
+        result.erase(unique(result.begin(), result.end()), result.end());
+        return result;
+    }
+
+    vector<PersonId> findCommonAncestors(PersonId a, PersonId b, WorkerPool *pool = nullptr) const {
+        auto of_a = findAllAncestorsOf(a, pool);
+        auto of_b = findAllAncestorsOf(b, pool);
+        vector<PersonId> result;
+        set_intersection(of_a.begin(), of_a.end(), of_b.begin(), of_b.end(), back_inserter(result));
+        return result;
+    }
+
+private:
+    static RelationshipGraph from_interned(const IndexedRelationships &interned,
+                                           const vector<pair<PersonId, PersonId>> &edges) {
+        vector<string> person_names;
+        person_names.reserve(interned.person_count());
+        for (PersonId p = 0; p < interned.person_count(); ++p)
+            person_names.push_back(interned.name_of(p));
+        return {interned.person_count(), edges, std::move(person_names)};
+    }
+};
@@ -0,0 +1,119 @@
+#pragma once
+
+#include <common.h>
+#include "html_sink.h"
+
+/**
+ * BUILDER
+ *
+ * Start off by creating OOP parts to define the different parts you are building.
+ * For example, in our case, we have a top-level HTML element.
+ */
+
+/**
+ * This is just a way to model an HTML element via OOP.
+ * The actual builder is below.
+ */
+struct HtmlElement {
+    string name, text;
+    vector<HtmlElement> elements;
+
+    // Define indentation size.
+    const size_t indent_size = 2;
+
+    HtmlElement() {}
+
+    HtmlElement(const string &name, const string &text) : name(name), text(text) {}
+
+    /**
+     * Print it. Note that the indentation level increases as you go.
+     */
+    string str(int indent = 0) const {
+        ostringstream oss;
+        string i(indent_size * indent, ' ');
+
+        oss << i << "<" << name << ">" << endl;
+        if (!text.empty())
+            oss << string(indent_size * (indent + 1), ' ') << text << endl;
+
+        for (const auto &e: elements)
+            oss << e.str(indent + 1);
+
+        oss << i << "</" << name << ">" << endl;
+        return oss.str();
+    }
+
+    /**
+     * The same output as str, but written straight into the sink in one pass, instead of every element building
+     * a string that its parent then copies again.
+     */
+    void render(HtmlSink &sink, int indent = 0) const {
+        render_open(sink, indent);
+        for (const auto &e: elements)
+            e.render(sink, indent + 1);
+        render_close(sink, indent);
+    }
+
+    /**
+     * What render writes before the children, and after them.
+     */
+    void render_open(HtmlSink &sink, int indent) const {
+        sink.spaces(indent_size * indent).append('<').append(name).append(">\n");
+        if (!text.empty())
+            sink.spaces(indent_size * (indent + 1)).append(text).append('\n');
+    }
+
+    void render_close(HtmlSink &sink, int indent) const {
+        sink.spaces(indent_size * indent).append("</").append(name).append(">\n");
+    }
+};
+
+
+template <> struct RenderTraits<HtmlElement> {
+    static const vector<HtmlElement> &children(const HtmlElement &e) { return e.elements; }
+    static void open(const HtmlElement &e, HtmlSink &sink, int depth) { e.render_open(sink, depth); }
+    static void close(const HtmlElement &e, HtmlSink &sink, int depth) { e.render_close(sink, depth); }
+};
+
+/**
+ * The builder.
+ *
+ * It will allow us to define the root of our element, and then add children in a simple fashion.
+ * Note that we are using the HtmlBuilder to build up our much more complex HtmlElement object.
+ *
+ * Instead of creating the object in a single line, we are doing so piece-wise with special components that
+ * help us at each step of the way.
+ *
+ * After the construction, you call the appropriate function (here: str) to get whatever is it you've constructed.
+ */
+struct HtmlBuilder {
+    HtmlElement root;
+
+    /**
+     * Constructor: inconvenient to work with HTML elements. Just want to work with strings.
+     *
+     * If someone wants a string UL in here, they can just pass that.
+     */
+    HtmlBuilder(string rootName) {
+        root.name = rootName;
+    }
+
+    /**
+     * Add children: create new HtmlElement and make it a child.
+     */
+     void addChild(string childName, string childText) {
+         HtmlElement e{childName, childText};
+         root.elements.emplace_back(e);
+     }
+
+     /**
+      * An str function to show what we've actually built.
+      */
+    string str() const {
+        return root.str();
+    }
+
+    void render(HtmlSink &sink) const {
+        root.render(sink);
+    }
+};
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <common.h>
+#include "html_sink.h"
 
 /**
  * FLUENT FORCED BUILDER
@@ -20,6 +21,7 @@ class HtmlBuilder;
  */
 class HtmlElement {
     friend class HtmlBuilder;
+    friend class IncrementalHtml;
 
 private:
     string name, text;
@@ -33,12 +35,39 @@ private:
     HtmlElement(string name, string text) : name(std::move(name)), text(std::move(text)) {}
 
 public:
+    /**
+     * Only HtmlBuilder can make a Key, so only it can use the constructor below. Because that constructor is public,
+     * though, a vector can call it: the builder constructs children in place with emplace_back.
+     */
+    class Key {
+        friend class HtmlBuilder;
+        Key() {}
+    };
+
+    HtmlElement(Key, string name, string text) : name(std::move(name)), text(std::move(text)) {}
+
     /**
      * Print it. The building up of these elements is where the builder element comes into play.
      * Note that the indentation level increases as you go.
      */
     string str(int indent = 0) const;
 
+    /**
+     * Writes the same output as str straight into the sink, in one pass over the tree.
+     */
+    void render(HtmlSink &sink, int indent = 0) const;
+
+    /**
+     * The exact number of bytes that str(indent) returns, counted without rendering anything.
+     */
+    size_t rendered_size(int indent = 0) const;
+
+    /**
+     * The same as str, but measured first and then rendered into one allocation of exactly the right size,
+     * instead of strings that grow, and get copied into their parents, as they go.
+     */
+    string str_presized(int indent = 0) const;
+
     /**
      * Easy way to convert from an HtmlElement to an HtmlBuilder.
      */
@@ -71,18 +100,32 @@ public:
     /**
      * Add children: create new HtmlElement and make it a child.
      * NOTE: instead of void, we now return this.
+     *
+     * Called on a temporary builder (as in HtmlElement::create(...).addChild(...)), addChild returns the builder as
+     * an rvalue, so that the conversion or build() at the end of the chain moves the root out instead of copying it.
+     */
+    HtmlBuilder &addChild(string childName, string childText) &;
+    HtmlBuilder &&addChild(string childName, string childText) &&;
+
+    /**
+     * Add an element that was built separately, so that elements can be nested.
      */
-    HtmlBuilder &addChild(const string &childName, const string &childText);
+    HtmlBuilder &addChild(HtmlElement child) &;
+    HtmlBuilder &&addChild(HtmlElement child) &&;
 
     /**
      * CONVERSION OPERATOR!
      * This allows us to automatically convert an HtmlBuilder to an HtmlElement.
      * See the end of main in the cpp file.
      *
-     * If this is the last thing you will do, you can move the root out of here using
-     * std::move to avoid copying.
+     * A named builder gives a copy and can keep building. If this is the last thing you will do with it, use
+     * std::move(builder) to move the root out instead; a temporary builder at the end of a chain does so by itself.
      */
-    operator HtmlElement() const {
+    operator HtmlElement() const & {
+        return root;
+    }
+
+    operator HtmlElement() && {
         return std::move(root);
     }
 
@@ -92,8 +135,11 @@ public:
      */
     string str() const;
 
+    void render(HtmlSink &sink) const;
+
     /**
-     * Returns the built HtmlElement once you are done with the builder.
+     * Returns the built HtmlElement once you are done with the builder: a copy, or the root itself on an rvalue.
      */
-    HtmlElement build() { return root; }
+    HtmlElement build() const & { return root; }
+    HtmlElement build() && { return std::move(root); }
 };
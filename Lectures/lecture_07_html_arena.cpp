@@ -0,0 +1,84 @@
+#include <chrono>
+
+#include "lecture_07_fluent_builder.h"
+#include "lecture_07_html_arena.h"
+#define COUNT_ALLOCATIONS
+#include "bench_util.h"
+#include "html_bench_trees.h"
+
+/**
+ * The bushy tree of html_bench_trees.h, built into an HtmlDocument.
+ */
+void nested_document(HtmlDocumentBuilder &builder, size_t count, size_t fanout, size_t &item) {
+    split_bushy_tree(count, fanout, [&] { builder.addChild("li", "item " + to_string(item++)); }, [&](size_t share) {
+        auto child = builder.child("ul");
+        nested_document(child, share, fanout, item);
+    });
+}
+
+/**
+ * Builds, renders and destroys each document with HtmlElement and with HtmlDocument, counting time and heap
+ * allocations for the build, and checks that both render the same HTML.
+ * Usage: lecture_07_html_arena [elements]
+ */
+int main(int argc, char *argv[]) {
+    size_t elements = max<size_t>(2, argc > 1 ? stoull(argv[1]) : 1'000'000);
+
+    auto measure = [&](const char *label, auto build) {
+        auto before = heap_stats.allocations;
+        auto start = chrono::steady_clock::now();
+        auto document = build();
+        auto build_time = seconds_since(start);
+        auto built_allocations = heap_stats.allocations - before;
+
+        auto html = document.str();
+
+        start = chrono::steady_clock::now();
+        { auto dying = std::move(document); }
+        auto destroy_time = seconds_since(start);
+
+        cout << "  " << label << built_allocations << " allocations, build " << build_time * 1e3 << " ms, destroy "
+             << destroy_time * 1e3 << " ms" << endl;
+        return html;
+    };
+
+    cout << "flat list of " << elements << " elements" << endl;
+    auto flat_elements = measure("HtmlElement:  ", [&] {
+        auto builder = HtmlElement::create("ul");
+        for (size_t i = 1; i < elements; ++i)
+            builder.addChild("li", "item " + to_string(i));
+        return builder.build();
+    });
+    auto flat_document = measure("HtmlDocument: ", [&] {
+        auto builder = HtmlDocument::create("ul");
+        for (size_t i = 1; i < elements; ++i)
+            builder.addChild("li", "item " + to_string(i));
+        return builder.build();
+    });
+
+    cout << "tree of " << elements << " elements, 10 children each" << endl;
+    auto tree_elements = measure("HtmlElement:  ", [&] {
+        size_t item = 0;
+        return bushy_tree(elements, 10, item);
+    });
+    auto tree_document = measure("HtmlDocument: ", [&] {
+        size_t item = 0;
+        auto builder = HtmlDocument::create("ul");
+        nested_document(builder, elements, 10, item);
+        return builder.build();
+    });
+
+    {
+        HtmlDocument document = HtmlDocument::create("ul").addChild("li", "hello").addChild("li", "world");
+        auto &arena = document.memory();
+        cout << document.str() << document.size() << " elements in " << arena.bytes_used() << " bytes of "
+             << arena.block_count() << " arena block(s)" << endl;
+    }
+
+    if (flat_elements != flat_document || tree_elements != tree_document) {
+        cerr << "HtmlDocument does not render the same HTML as HtmlElement" << endl;
+        return 1;
+    }
+
+    return 0;
+}
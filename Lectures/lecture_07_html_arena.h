@@ -0,0 +1,160 @@
+#pragma once
+
+#include <stdexcept>
+
+#include <common.h>
+#include "arena.h"
+#include "html_sink.h"
+
+/**
+ * ARENA-ALLOCATED HTML DOCUMENTS
+ *
+ * Every HtmlElement owns its name, its text and a vector of children, so building a document costs at least one
+ * heap allocation per element, plus copies whenever a children vector grows.
+ *
+ * An HtmlDocument keeps all of its elements, names and texts in one Arena instead. Children are linked in a list
+ * (first child, last child, next sibling), so adding one is O(1) and never moves anything, and the whole document
+ * is freed at once, block by block, when it goes away.
+ *
+ * HtmlDocumentBuilder has the fluent surface of HtmlBuilder: HtmlDocument::create(root), addChild(name, text),
+ * then build() or a conversion to HtmlDocument. child(name) adds a nested element and returns a builder for it.
+ *
+ * It is a builder of its own rather than HtmlBuilder on top of an arena. HtmlBuilder builds HtmlElements, which
+ * are values: they own their strings and children, are copied and moved between builders, nested into elements
+ * built elsewhere, and rendered long after their builder is gone, by IncrementalHtml and ParallelRenderer among
+ * others. Elements pointing into an arena would have to keep that arena alive, and every one of those users
+ * would change. So existing code keeps HtmlElement, and code that builds large documents once switches from
+ * HtmlElement::create to HtmlDocument::create; the addChild chains stay the same, and nesting an element built
+ * separately becomes child(name).
+ */
+struct ArenaElement {
+    string_view name, text;
+    ArenaElement *first_child{nullptr};
+    ArenaElement *last_child{nullptr};
+    ArenaElement *next_sibling{nullptr};
+
+    // Define indentation size.
+    static constexpr size_t indent_size = 2;
+
+    /**
+     * The same output as HtmlElement::render.
+     */
+    void render(HtmlSink &sink, int indent = 0) const {
+        sink.spaces(indent_size * indent).append('<').append(name).append(">\n");
+        if (!text.empty())
+            sink.spaces(indent_size * (indent + 1)).append(text).append('\n');
+
+        for (auto e = first_child; e; e = e->next_sibling)
+            e->render(sink, indent + 1);
+
+        sink.spaces(indent_size * indent).append("</").append(name).append(">\n");
+    }
+
+    string str(int indent = 0) const {
+        BufferSink sink;
+        render(sink, indent);
+        return sink.take();
+    }
+};
+
+class HtmlDocumentBuilder;
+
+class HtmlDocument {
+    friend class HtmlDocumentBuilder;
+
+    // On the heap so that builders for nested elements can keep pointing at it while the document moves.
+    struct Storage {
+        Arena arena;
+        size_t elements{0};
+    };
+
+    unique_ptr<Storage> storage;
+    ArenaElement *root{nullptr};
+
+    HtmlDocument() = default;
+
+public:
+    HtmlDocument(HtmlDocument&&) noexcept = default;
+    HtmlDocument &operator=(HtmlDocument&&) noexcept = default;
+
+    static HtmlDocumentBuilder create(string_view root_name);
+
+    string str() const { return root->str(); }
+    void render(HtmlSink &sink) const { root->render(sink); }
+
+    const ArenaElement &root_element() const { return *root; }
+    size_t size() const { return storage->elements; }
+    const Arena &memory() const { return storage->arena; }
+};
+
+class HtmlDocumentBuilder {
+    friend class HtmlDocument;
+
+    // Only the root builder owns the document; builders returned by child() just point into it.
+    HtmlDocument document;
+    HtmlDocument::Storage *storage;
+    ArenaElement *element;
+
+    HtmlDocumentBuilder(HtmlDocument::Storage *storage, ArenaElement *element)
+            : storage(storage), element(element) {}
+
+    explicit HtmlDocumentBuilder(string_view root_name) {
+        document.storage = make_unique<HtmlDocument::Storage>();
+        storage = document.storage.get();
+        element = document.root = make_element(root_name, {});
+    }
+
+    ArenaElement *make_element(string_view name, string_view text) {
+        auto e = storage->arena.make<ArenaElement>();
+        e->name = storage->arena.copy(name);
+        e->text = storage->arena.copy(text);
+        ++storage->elements;
+        return e;
+    }
+
+    ArenaElement *append(string_view name, string_view text) {
+        auto e = make_element(name, text);
+        if (element->last_child)
+            element->last_child->next_sibling = e;
+        else
+            element->first_child = e;
+        element->last_child = e;
+        return e;
+    }
+
+public:
+    /**
+     * Add a child with text; the strings are copied into the document.
+     */
+    HtmlDocumentBuilder &addChild(string_view childName, string_view childText) {
+        append(childName, childText);
+        return *this;
+    }
+
+    /**
+     * Add a child without text and return a builder for it, to nest elements inside it.
+     */
+    HtmlDocumentBuilder child(string_view childName) {
+        return {storage, append(childName, {})};
+    }
+
+    /**
+     * Takes the document out of the builder: the builder must not be used afterwards.
+     */
+    HtmlDocument build() {
+        if (!document.storage)
+            throw logic_error("HtmlDocumentBuilder: only the builder from HtmlDocument::create can build");
+        return std::move(document);
+    }
+
+    operator HtmlDocument() {
+        return build();
+    }
+
+    string str() const { return element->str(); }
+    void render(HtmlSink &sink) const { element->render(sink); }
+};
+
+inline HtmlDocumentBuilder HtmlDocument::create(string_view root_name) {
+    return HtmlDocumentBuilder{root_name};
+}
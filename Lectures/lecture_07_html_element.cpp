@@ -0,0 +1,84 @@
+#include "lecture_07_fluent_builder.h"
+
+string HtmlElement::str(int indent) const {
+    ostringstream oss;
+    string i(indent_size * indent, ' ');
+
+    oss << i << "<" << name << ">" << endl;
+    if (!text.empty())
+        oss << string(indent_size * (indent + 1), ' ') << text << endl;
+
+    for (const auto &e: elements)
+        oss << e.str(indent + 1);
+
+    oss << i << "</" << name << ">" << endl;
+    return oss.str();
+}
+
+void HtmlElement::render(HtmlSink &sink, int indent) const {
+    sink.spaces(indent_size * indent).append('<').append(name).append(">\n");
+    if (!text.empty())
+        sink.spaces(indent_size * (indent + 1)).append(text).append('\n');
+
+    for (const auto &e: elements)
+        e.render(sink, indent + 1);
+
+    sink.spaces(indent_size * indent).append("</").append(name).append(">\n");
+}
+
+size_t HtmlElement::rendered_size(int indent) const {
+    // "<name>\n" and "</name>\n", each indented.
+    size_t size = 2 * (indent_size * indent + name.size()) + 3 + 4;
+    if (!text.empty())
+        size += indent_size * (indent + 1) + text.size() + 1;
+
+    for (const auto &e: elements)
+        size += e.rendered_size(indent + 1);
+    return size;
+}
+
+string HtmlElement::str_presized(int indent) const {
+    BufferSink sink{rendered_size(indent)};
+    render(sink, indent);
+    return sink.take();
+}
+
+/**
+ * The starting point for creating an HtmlElement.
+ */
+HtmlBuilder HtmlElement::create(const string &root_name) {
+    return {root_name};
+}
+
+/**
+ * CLion incorrectly says this is not being used: it is implicitly being used in the HtmlElement::create method.
+ */
+HtmlBuilder::HtmlBuilder(const string &root_name) {
+    root.name = root_name;
+}
+
+HtmlBuilder &HtmlBuilder::addChild(string childName, string childText) & {
+    root.elements.emplace_back(HtmlElement::Key{}, std::move(childName), std::move(childText));
+    return *this;
+}
+
+HtmlBuilder &&HtmlBuilder::addChild(string childName, string childText) && {
+    return std::move(addChild(std::move(childName), std::move(childText)));
+}
+
+HtmlBuilder &HtmlBuilder::addChild(HtmlElement child) & {
+    root.elements.push_back(std::move(child));
+    return *this;
+}
+
+HtmlBuilder &&HtmlBuilder::addChild(HtmlElement child) && {
+    return std::move(addChild(std::move(child)));
+}
+
+string HtmlBuilder::str() const {
+    return root.str();
+}
+
+void HtmlBuilder::render(HtmlSink &sink) const {
+    root.render(sink);
+}
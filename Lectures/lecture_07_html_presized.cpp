@@ -0,0 +1,55 @@
+#include <chrono>
+
+#include "lecture_07_fluent_builder.h"
+#define COUNT_ALLOCATIONS
+#include "bench_util.h"
+#include "html_bench_trees.h"
+
+/**
+ * Renders the same page many times, as a server would, with str(), with render() into a BufferSink that grows,
+ * and with str_presized(), and reports time and heap allocations per render.
+ * Usage: lecture_07_html_presized [elements per page] [renders]
+ */
+int main(int argc, char *argv[]) {
+    size_t elements = max<size_t>(2, argc > 1 ? stoull(argv[1]) : 1'000);
+    size_t renders = max<size_t>(1, argc > 2 ? stoull(argv[2]) : 2'000);
+
+    size_t item = 0;
+    HtmlElement root = bushy_tree(elements, 8, item, "item number ", " of the page");
+    auto expected = root.str();
+    if (root.rendered_size() != expected.size()) {
+        cerr << "rendered_size() is " << root.rendered_size() << ", str() has " << expected.size() << endl;
+        return 1;
+    }
+
+    bool same = true;
+    auto measure = [&](const char *label, auto render) {
+        auto before = heap_stats.allocations;
+        auto start = chrono::steady_clock::now();
+        size_t bytes = 0;
+        for (size_t r = 0; r < renders; ++r) {
+            auto html = render();
+            bytes += html.size();
+            same = same && html == expected;
+        }
+        auto time = seconds_since(start);
+        cout << "  " << label << time / renders * 1e6 << " us, "
+             << double(heap_stats.allocations - before) / renders << " allocations per render" << endl;
+    };
+
+    cout << elements << "-element page, " << expected.size() << " bytes, rendered " << renders << " times" << endl;
+    measure("str():               ", [&] { return root.str(); });
+    measure("render(BufferSink):  ", [&] {
+        BufferSink sink;
+        root.render(sink);
+        return sink.take();
+    });
+    measure("str_presized():      ", [&] { return root.str_presized(); });
+
+    if (!same) {
+        cerr << "Some render does not match str()" << endl;
+        return 1;
+    }
+
+    return 0;
+}
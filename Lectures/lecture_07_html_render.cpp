@@ -0,0 +1,82 @@
+#include <chrono>
+
+#include <fcntl.h>
+
+#include "lecture_07_fluent_builder.h"
+#include "bench_util.h"
+#include "html_bench_trees.h"
+
+/**
+ * A chain of nested divs, depth elements deep, ending in a paragraph.
+ */
+HtmlElement chain(size_t depth, size_t &item) {
+    if (depth <= 1)
+        return HtmlElement::create("div").addChild("p", "item " + to_string(item++));
+    return HtmlElement::create("div").addChild(chain(depth - 1, item));
+}
+
+/**
+ * Renders 1M-element documents, one wide and shallow and one made of deep chains, with str() and with render()
+ * into each kind of sink, and checks that every sink gets exactly what str() returns.
+ * Usage: lecture_07_html_render [elements] [chain depth]
+ */
+int main(int argc, char *argv[]) {
+    size_t elements = argc > 1 ? stoull(argv[1]) : 1'000'000;
+    size_t depth = max<size_t>(2, argc > 2 ? stoull(argv[2]) : 50);
+
+    size_t item = 0;
+    HtmlElement wide = bushy_tree(elements, 10, item);
+
+    auto deep_builder = HtmlElement::create("body");
+    for (size_t made = 1; made + depth + 1 <= elements; made += depth + 1)
+        deep_builder.addChild(chain(depth, item));
+    HtmlElement deep = deep_builder;
+
+    int dev_null = ::open("/dev/null", O_WRONLY);
+    if (dev_null < 0)
+        throw system_error(errno, generic_category(), "open /dev/null");
+
+    for (auto document: {make_pair("wide", &wide), make_pair("deep", &deep)}) {
+        auto &root = *document.second;
+
+        auto start = chrono::steady_clock::now();
+        auto expected = root.str();
+        auto str_time = seconds_since(start);
+
+        start = chrono::steady_clock::now();
+        BufferSink buffer;
+        root.render(buffer);
+        auto buffer_time = seconds_since(start);
+
+        ostringstream oss;
+        start = chrono::steady_clock::now();
+        {
+            OstreamSink sink{oss};
+            root.render(sink);
+        }
+        auto ostream_time = seconds_since(start);
+
+        start = chrono::steady_clock::now();
+        {
+            FdSink sink{dev_null};
+            root.render(sink);
+            sink.flush();
+        }
+        auto fd_time = seconds_since(start);
+
+        auto mb = expected.size() / double(1 << 20);
+        cout << document.first << " document, " << mb << " MB of HTML" << endl
+             << "  str():                  " << str_time * 1e3 << " ms" << endl
+             << "  render to BufferSink:   " << buffer_time * 1e3 << " ms" << endl
+             << "  render to OstreamSink:  " << ostream_time * 1e3 << " ms" << endl
+             << "  render to /dev/null fd: " << fd_time * 1e3 << " ms" << endl;
+
+        if (buffer.view() != expected || oss.str() != expected) {
+            cerr << "render() does not match str() on the " << document.first << " document" << endl;
+            return 1;
+        }
+    }
+
+    ::close(dev_null);
+    return 0;
+}
@@ -0,0 +1,171 @@
+#include <chrono>
+#include <cstdio>
+
+#include <fcntl.h>
+#include <sys/resource.h>
+
+#include "lecture_07_html_stream.h"
+#define COUNT_ALLOCATIONS
+#include "bench_util.h"
+
+/**
+ * An FdSink that counts what it has written.
+ */
+class CountingFdSink : public FdSink {
+protected:
+    void write(const char *data, size_t size) override {
+        written += size;
+        FdSink::write(data, size);
+    }
+
+public:
+    size_t written{0};
+
+    explicit CountingFdSink(int fd) : FdSink(fd) {}
+};
+
+string_view title(char (&buffer)[64], size_t section) {
+    auto n = snprintf(buffer, sizeof buffer, "Section %zu", section);
+    return {buffer, size_t(n)};
+}
+
+string_view cell(char (&buffer)[64], size_t section, size_t row, size_t column) {
+    auto n = snprintf(buffer, sizeof buffer, "row %zu, column %zu of section %zu", row, column, section);
+    return {buffer, size_t(n)};
+}
+
+constexpr size_t rows = 8, columns = 4;
+
+/**
+ * A section of the report: a heading and a table, streamed.
+ */
+void section(HtmlStream &html, size_t n) {
+    char buffer[64];
+    html.open("section").addChild("h2", title(buffer, n)).open("table");
+    for (size_t r = 0; r < rows; ++r) {
+        html.open("tr");
+        for (size_t c = 0; c < columns; ++c)
+            html.addChild("td", cell(buffer, n, r, c));
+        html.close("tr");
+    }
+    html.close("table").close("section");
+}
+
+/**
+ * The same section, built as a tree.
+ */
+HtmlElement section_tree(size_t n) {
+    char buffer[64];
+    auto table = HtmlElement::create("table");
+    for (size_t r = 0; r < rows; ++r) {
+        auto tr = HtmlElement::create("tr");
+        for (size_t c = 0; c < columns; ++c)
+            tr.addChild("td", string(cell(buffer, n, r, c)));
+        table.addChild(std::move(tr));
+    }
+    return HtmlElement::create("section").addChild("h2", string(title(buffer, n))).addChild(std::move(table));
+}
+
+/**
+ * Streams sections into the sink until at least bytes have been written.
+ */
+size_t report(CountingFdSink &sink, size_t bytes) {
+    HtmlStream html{sink};
+    html.open("report");
+    size_t sections = 0;
+    while (sink.written < bytes)
+        section(html, sections++);
+    html.close();
+    html.finish();
+    return sections;
+}
+
+template <typename Event> bool throws_logic_error(Event event) {
+    BufferSink sink;
+    HtmlStream html{sink};
+    try {
+        event(html);
+    } catch (const logic_error &) {
+        return true;
+    }
+    return false;
+}
+
+/**
+ * Streams a generated report of the given size, and shows that the heap stays the same size however big the
+ * report gets: a report a hundred times smaller needs exactly as much. Also checks that the stream renders what
+ * HtmlElement does, and that it rejects bad nesting.
+ * Usage: lecture_07_html_stream [bytes] [output file, /dev/null by default]
+ */
+int main(int argc, char *argv[]) {
+    size_t bytes = max<size_t>(1, argc > 1 ? stoull(argv[1]) : size_t(10) << 30);
+    const char *path = argc > 2 ? argv[2] : "/dev/null";
+
+    {
+        auto tree = HtmlElement::create("report");
+        BufferSink sink;
+        HtmlStream html{sink};
+        html.open("report");
+        for (size_t s = 0; s < 100; ++s) {
+            tree.addChild(section_tree(s));
+            section(html, s);
+        }
+        html.addChild(section_tree(100)).close();
+        tree.addChild(section_tree(100));
+        html.finish();
+        if (sink.view() != tree.str()) {
+            cerr << "HtmlStream does not render what HtmlElement does" << endl;
+            return 1;
+        }
+    }
+
+    bool rejected = throws_logic_error([](HtmlStream &html) { html.close(); }) &&
+                    throws_logic_error([](HtmlStream &html) { html.text("loose"); }) &&
+                    throws_logic_error([](HtmlStream &html) { html.open("ul").open("li").close("ul"); }) &&
+                    throws_logic_error([](HtmlStream &html) { html.open("p").text("a").text("b"); }) &&
+                    throws_logic_error([](HtmlStream &html) { html.open("ul").addChild("li", "").text("late"); }) &&
+                    throws_logic_error([](HtmlStream &html) { html.open("ul").finish(); });
+    if (!rejected) {
+        cerr << "HtmlStream accepted bad nesting" << endl;
+        return 1;
+    }
+
+    int fd = ::open(path, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0)
+        throw system_error(errno, generic_category(), string("open ") + path);
+
+    auto measure = [&](size_t target, size_t &written) {
+        CountingFdSink sink{fd};
+        auto before = heap_stats.bytes;
+        heap_stats.reset_peak();
+        auto start = chrono::steady_clock::now();
+        auto sections = report(sink, target);
+        auto time = seconds_since(start);
+        written = sink.written;
+        auto growth = heap_stats.peak - before;
+        cout << "  " << written << " bytes (" << sections << " sections) in " << time << " s, "
+             << written / time / (1 << 20) << " MB/s, peak heap " << growth << " bytes" << endl;
+        return growth;
+    };
+
+    size_t small_written, written;
+    cout << "Streaming a report to " << path << endl;
+    auto small_growth = measure(max<size_t>(1, bytes / 100), small_written);
+    if (::ftruncate(fd, 0) < 0 && errno != EINVAL)
+        throw system_error(errno, generic_category(), "ftruncate");
+    ::lseek(fd, 0, SEEK_SET);
+    auto growth = measure(bytes, written);
+    ::close(fd);
+
+    rusage usage{};
+    getrusage(RUSAGE_SELF, &usage);
+    cout << "  max resident set: " << usage.ru_maxrss / 1024 << " MB" << endl;
+
+    if (growth > small_growth) {
+        cerr << "The heap grew with the report: " << small_growth << " bytes for " << small_written
+             << " bytes of output, " << growth << " for " << written << endl;
+        return 1;
+    }
+
+    return 0;
+}
@@ -0,0 +1,134 @@
+#pragma once
+
+#include <stdexcept>
+
+#include "lecture_07_fluent_builder.h"
+
+/**
+ * STREAMING HTML BUILDER
+ *
+ * HtmlBuilder holds the whole tree until it is rendered, which takes more memory than the output itself. When all
+ * we want is the output, no tree is needed.
+ *
+ * HtmlStream takes the document as events: open an element, give it its text, close it. Each event is rendered
+ * into an HtmlSink at once, exactly as HtmlElement::render would render the same tree. All the stream keeps is the
+ * names of the elements that are still open. It needs them to close those elements and to check the nesting.
+ * Its memory is O(depth) however long the document gets, and once the stack is as deep as it will get, events
+ * allocate nothing.
+ *
+ *     HtmlStream html{sink};
+ *     html.open("ul").addChild("li", "hello").addChild("li", "world").close();
+ *     html.finish();
+ *
+ * Like an HtmlElement, an element has at most one text, which comes before its children. Events that break these
+ * rules or the nesting throw logic_error before writing anything. That covers closing an element that is not
+ * open, text outside any element, text after the first, text after a child, and finishing with elements still
+ * open.
+ */
+class HtmlStream {
+    struct Open {
+        string name;
+        bool has_content;
+    };
+
+    static constexpr size_t indent_size = 2;
+
+    HtmlSink &sink;
+    // open[0, depth) are the open elements, innermost last; the rest are kept for their string buffers.
+    vector<Open> open_elements;
+    size_t open_depth{0};
+
+    /**
+     * The element that is about to get a child: it now has content, so no more text.
+     */
+    void start_child() {
+        if (open_depth > 0)
+            open_elements[open_depth - 1].has_content = true;
+    }
+
+public:
+    explicit HtmlStream(HtmlSink &sink) : sink(sink) {}
+
+    HtmlStream(const HtmlStream&) = delete;
+    HtmlStream &operator=(const HtmlStream&) = delete;
+
+    /**
+     * The number of open elements.
+     */
+    size_t depth() const { return open_depth; }
+
+    HtmlStream &open(string_view name) {
+        start_child();
+        sink.spaces(indent_size * open_depth).append('<').append(name).append(">\n");
+        if (open_depth == open_elements.size())
+            open_elements.emplace_back();
+        auto &element = open_elements[open_depth++];
+        element.name.assign(name.data(), name.size());
+        element.has_content = false;
+        return *this;
+    }
+
+    /**
+     * The text of the innermost open element. Empty text writes nothing, as with HtmlElement.
+     */
+    HtmlStream &text(string_view text) {
+        if (open_depth == 0)
+            throw logic_error("HtmlStream: text outside any element");
+        auto &element = open_elements[open_depth - 1];
+        if (element.has_content)
+            throw logic_error("HtmlStream: <" + element.name + "> already has text or children");
+        if (!text.empty()) {
+            sink.spaces(indent_size * open_depth).append(text).append('\n');
+            element.has_content = true;
+        }
+        return *this;
+    }
+
+    /**
+     * Closes the innermost open element.
+     */
+    HtmlStream &close() {
+        if (open_depth == 0)
+            throw logic_error("HtmlStream: close with no element open");
+        --open_depth;
+        sink.spaces(indent_size * open_depth).append("</").append(open_elements[open_depth].name).append(">\n");
+        return *this;
+    }
+
+    /**
+     * Closes the innermost open element, which must be called name.
+     */
+    HtmlStream &close(string_view name) {
+        if (open_depth == 0)
+            throw logic_error("HtmlStream: close </" + string(name) + "> with no element open");
+        if (open_elements[open_depth - 1].name != name)
+            throw logic_error("HtmlStream: close </" + string(name) + "> inside <" +
+                              open_elements[open_depth - 1].name + ">");
+        return close();
+    }
+
+    /**
+     * A child with only text, as HtmlBuilder::addChild adds it.
+     */
+    HtmlStream &addChild(string_view childName, string_view childText) {
+        return open(childName).text(childText).close();
+    }
+
+    /**
+     * A child that was built as a tree, such as a small part of the document that is easier to build whole.
+     */
+    HtmlStream &addChild(const HtmlElement &child) {
+        start_child();
+        child.render(sink, static_cast<int>(open_depth));
+        return *this;
+    }
+
+    /**
+     * Checks that every element was closed, and flushes the sink.
+     */
+    void finish() {
+        if (open_depth > 0)
+            throw logic_error("HtmlStream: <" + open_elements[open_depth - 1].name + "> is still open");
+        sink.flush();
+    }
+};
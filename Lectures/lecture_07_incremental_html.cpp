@@ -0,0 +1,65 @@
+#include <chrono>
+#include <random>
+
+#include "lecture_07_incremental_html.h"
+#include "bench_util.h"
+#include "html_bench_trees.h"
+
+/**
+ * Between renders, changes the text of a random churn fraction of the elements and adds one element, then
+ * compares re-rendering only what changed with rendering everything again.
+ * Usage: lecture_07_incremental_html [elements] [churn] [rounds]
+ */
+int main(int argc, char *argv[]) {
+    size_t elements = max<size_t>(2, argc > 1 ? stoull(argv[1]) : 100'000);
+    double churn = argc > 2 ? stod(argv[2]) : 0.01;
+    size_t rounds = max<size_t>(1, argc > 3 ? stoull(argv[3]) : 20);
+
+    size_t item = 0;
+    HtmlElement element = bushy_tree(elements, 10, item);
+    IncrementalHtml html{element};
+    if (html.str() != element.str()) {
+        cerr << "IncrementalHtml does not render the same HTML as HtmlElement" << endl;
+        return 1;
+    }
+
+    mt19937_64 rng{42};
+    auto changes = max<size_t>(1, static_cast<size_t>(churn * html.size()));
+    double incremental_time = 0, full_time = 0, str_time = 0;
+    IncrementalHtml::RenderStats stats;
+
+    for (size_t round = 0; round < rounds; ++round) {
+        for (size_t c = 0; c < changes; ++c)
+            html.set_text(rng() % html.size(), "changed in round " + to_string(round));
+        html.add_child(rng() % html.size(), "li", "added in round " + to_string(round));
+
+        auto start = chrono::steady_clock::now();
+        string incremental = html.str();
+        incremental_time += seconds_since(start);
+        stats = html.last_render();
+
+        html.invalidate();
+        start = chrono::steady_clock::now();
+        auto &full = html.str();
+        full_time += seconds_since(start);
+
+        if (incremental != full) {
+            cerr << "Incremental render differs from a full render in round " << round << endl;
+            return 1;
+        }
+
+        start = chrono::steady_clock::now();
+        auto reference = element.str();
+        str_time += seconds_since(start);
+    }
+
+    cout << html.size() << " elements, " << html.str().size() << " bytes, " << changes << " changed per round" << endl
+         << "  HtmlElement::str():    " << str_time / rounds * 1e3 << " ms" << endl
+         << "  full render:           " << full_time / rounds * 1e3 << " ms" << endl
+         << "  incremental render:    " << incremental_time / rounds * 1e3 << " ms ("
+         << full_time / incremental_time << "x faster)" << endl
+         << "  last round: " << stats.rendered_elements << " elements rendered, " << stats.spliced_fragments
+         << " fragments (" << stats.spliced_bytes << " bytes) spliced" << endl;
+
+    return 0;
+}
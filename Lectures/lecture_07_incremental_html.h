@@ -0,0 +1,164 @@
+#pragma once
+
+#include <stdexcept>
+
+#include "lecture_07_fluent_builder.h"
+
+/**
+ * INCREMENTAL RE-RENDERING
+ *
+ * HtmlElement::str() renders the whole tree every time, even if only a few elements changed since the last call.
+ *
+ * IncrementalHtml takes a copy of an HtmlElement tree that can be changed in place, and keeps the output of its
+ * last render. Every element remembers where its fragment is in that output (relative to its parent's fragment)
+ * and whether it changed since. A change marks the element and all of its ancestors dirty. The next str() walks
+ * down the dirty elements only: each of them is rendered again, while each clean child is spliced in from the
+ * previous output with a single copy, however big its subtree is.
+ *
+ * Elements are referred to by NodeId, which stays valid as the tree grows.
+ */
+class IncrementalHtml {
+public:
+    using NodeId = size_t;
+    static constexpr NodeId root = 0;
+
+    struct RenderStats {
+        size_t rendered_elements{0};
+        size_t spliced_fragments{0};
+        size_t spliced_bytes{0};
+    };
+
+private:
+    struct Node {
+        string name, text;
+        NodeId parent;
+        size_t depth;
+        vector<NodeId> children;
+
+        // The fragment in the last output, which starts offset bytes after the parent's fragment.
+        size_t offset{0};
+        size_t length{0};
+        bool dirty{true};
+    };
+
+    static constexpr size_t indent_size = 2;
+
+    vector<Node> nodes;
+    string output, next;
+    RenderStats stats;
+
+    NodeId add(NodeId parent, size_t depth, string name, string text) {
+        nodes.push_back(Node{std::move(name), std::move(text), parent, depth, {}});
+        return nodes.size() - 1;
+    }
+
+    void copy(const HtmlElement &element, NodeId id) {
+        for (const auto &child: element.elements) {
+            auto c = add(id, nodes[id].depth + 1, child.name, child.text);
+            nodes[id].children.push_back(c);
+            copy(child, c);
+        }
+    }
+
+    Node &node(NodeId id) {
+        if (id >= nodes.size())
+            throw out_of_range("IncrementalHtml: no element " + to_string(id));
+        return nodes[id];
+    }
+
+    /**
+     * old_start is where the element's fragment began in the previous output, new_parent where its parent's
+     * fragment begins in the new one.
+     */
+    void render(NodeId id, size_t old_start, size_t new_parent) {
+        auto start = next.size();
+        auto &n = nodes[id];
+
+        if (!n.dirty) {
+            next.append(output, old_start, n.length);
+            ++stats.spliced_fragments;
+            stats.spliced_bytes += n.length;
+        } else {
+            auto indent = indent_size * n.depth;
+            next.append(indent, ' ').append(1, '<').append(n.name).append(">\n");
+            if (!n.text.empty())
+                next.append(indent + indent_size, ' ').append(n.text).append(1, '\n');
+
+            for (auto c: n.children)
+                render(c, old_start + nodes[c].offset, start);
+
+            next.append(indent, ' ').append("</").append(n.name).append(">\n");
+            n.dirty = false;
+            ++stats.rendered_elements;
+        }
+
+        n.offset = start - new_parent;
+        n.length = next.size() - start;
+    }
+
+public:
+    explicit IncrementalHtml(const HtmlElement &element) {
+        add(root, 0, element.name, element.text);
+        copy(element, root);
+    }
+
+    size_t size() const { return nodes.size(); }
+    const string &name(NodeId id) const { return nodes.at(id).name; }
+    const string &text(NodeId id) const { return nodes.at(id).text; }
+    const vector<NodeId> &children(NodeId id) const { return nodes.at(id).children; }
+
+    /**
+     * Marks the element and its ancestors as needing a render. Ancestors of a dirty element are always dirty
+     * already, so this stops at the first one that is.
+     */
+    void mark_dirty(NodeId id) {
+        // The root is its own parent, so the walk ends there too.
+        for (auto n = &node(id); !n->dirty; n = &nodes[n->parent])
+            n->dirty = true;
+    }
+
+    void set_text(NodeId id, string text) {
+        node(id).text = std::move(text);
+        mark_dirty(id);
+    }
+
+    void set_name(NodeId id, string name) {
+        node(id).name = std::move(name);
+        mark_dirty(id);
+    }
+
+    NodeId add_child(NodeId parent, string name, string text = {}) {
+        auto depth = node(parent).depth + 1;
+        auto c = add(parent, depth, std::move(name), std::move(text));
+        nodes[parent].children.push_back(c);
+        mark_dirty(parent);
+        return c;
+    }
+
+    /**
+     * Forgets every cached fragment, so that the next str() renders everything.
+     */
+    void invalidate() {
+        for (auto &n: nodes)
+            n.dirty = true;
+    }
+
+    /**
+     * The same output as HtmlElement::str() would give for the current tree.
+     */
+    const string &str() {
+        stats = {};
+        if (nodes[root].dirty) {
+            next.clear();
+            next.reserve(output.size());
+            render(root, 0, 0);
+            swap(output, next);
+        }
+        return output;
+    }
+
+    /**
+     * What the last str() did.
+     */
+    RenderStats last_render() const { return stats; }
+};
@@ -0,0 +1,125 @@
+#pragma once
+
+#include <common.h>
+#include "html_escape.h"
+#include "html_sink.h"
+
+/**
+ * GROOVY-STYLE BUILDERS: DSLs
+ * This shows how we can essentially build a DSL (in this case, pseudo-HTML using uniform initialization syntax.
+ * Containment can be controlled as per the example.
+ * This allows us to define structures in a more natural, understandable way.
+ */
+
+/**
+ * HTML tag:
+ * <name attribute1=value1 attribute2=value2 ...>
+ *   text
+ *   <children>
+ * </name>
+ */
+struct Tag {
+    string name, text;
+    vector<Tag> children;
+    vector<pair<string,string>> attributes;
+
+    friend ostream &operator<<(ostream &os, const Tag &tag);
+
+    /**
+     * The same output as operator<<, written into a sink.
+     */
+    void render(HtmlSink &sink) const {
+        render_open(sink);
+        for (const auto &child: children)
+            child.render(sink);
+        render_close(sink);
+    }
+
+    /**
+     * What render writes before the children, and after them.
+     */
+    void render_open(HtmlSink &sink) const {
+        sink.append('<').append(name);
+        for (const auto &attrib: attributes) {
+            sink.append(' ').append(attrib.first).append("=\"");
+            escape_html(sink, attrib.second, true);
+            sink.append('"');
+        }
+
+        if (children.empty() && text.empty()) {
+            sink.append("/>\n");
+        } else {
+            sink.append(">\n");
+            if (!text.empty()) {
+                escape_html(sink, text);
+                sink.append('\n');
+            }
+        }
+    }
+
+    void render_close(HtmlSink &sink) const {
+        if (!children.empty() || !text.empty())
+            sink.append("</").append(name).append(">\n");
+    }
+
+protected:
+public:
+    Tag(const string &name, const string &text) : name{name}, text{text} {}
+    Tag(const string &name, const vector<Tag> &children) : name{name}, children{children} {}
+
+};
+
+template <> struct RenderTraits<Tag> {
+    static const vector<Tag> &children(const Tag &tag) { return tag.children; }
+    static void open(const Tag &tag, HtmlSink &sink, int) { tag.render_open(sink); }
+    static void close(const Tag &tag, HtmlSink &sink, int) { tag.render_close(sink); }
+};
+
+/**
+ * Some common tags.
+ */
+
+/**
+ * A paragraph can have children: formatting, images, etc.
+ * We accept these with an initialization list, which we can stick into a vector.
+ */
+struct P : Tag {
+    P(const string &text) : Tag{"p", text} {}
+    P(initializer_list<Tag> children) : Tag{"p", children} {}
+};
+
+struct IMG : Tag {
+    // Only has an attribute specifying URL of image, which we need to add:
+    explicit IMG(const string &url) : Tag{"img", ""} {
+        attributes.emplace_back(make_pair("src", url));
+    }
+};
+/**
+ * Outputs the tag to an output stream. Text and attribute values are escaped.
+ */
+inline ostream &operator<<(ostream &os, const Tag &tag) {
+    os << "<" << tag.name;
+    for (const auto &attrib: tag.attributes) {
+        os << " " << attrib.first << "=\"";
+        escape_html(os, attrib.second, true);
+        os << "\"";
+    }
+
+    if (tag.children.empty() && tag.text.empty())
+        os << "/>" << endl;
+    else {
+        os << ">" << endl;
+
+        if (!tag.text.empty()) {
+            escape_html(os, tag.text);
+            os << endl;
+        }
+
+        for (const auto &child: tag.children)
+            os << child;
+
+        os << "</" << tag.name << ">" << endl;
+    }
+
+    return os;
+}
@@ -0,0 +1,81 @@
+#include <chrono>
+#include <random>
+
+#include "html_escape.h"
+#include "lecture_08_groovy_style_builder.h"
+#include "bench_util.h"
+
+/**
+ * bytes of text with one character needing escape every period bytes on average (none if period is 0).
+ */
+string make_text(size_t bytes, size_t period, mt19937_64 &rng) {
+    static const string words[] = {"Pikachu", "used", "thunderbolt", "on", "the", "wild", "Snorlax", "which",
+                                    "kept", "sleeping", "through", "it", "all"};
+    static const char specials[] = {'&', '<', '>', '"', '\''};
+    string text;
+    text.reserve(bytes);
+    while (text.size() < bytes) {
+        text += words[rng() % size(words)];
+        text += period && rng() % period < 8 ? specials[rng() % size(specials)] : ' ';
+    }
+    text.resize(bytes);
+    return text;
+}
+
+/**
+ * The obvious escaper: look at every character.
+ */
+void escape_naive(HtmlSink &sink, string_view s, bool attribute) {
+    for (auto c: s) {
+        if (html_escape::needs_escape(c, attribute))
+            sink.append(html_escape::entity(c));
+        else
+            sink.append(c);
+    }
+}
+
+/**
+ * Escapes clean, lightly and heavily escaped text with memcpy as the baseline, and renders a Tag with a large text.
+ * Usage: lecture_08_html_escape [megabytes]
+ */
+int main(int argc, char *argv[]) {
+    size_t size = (argc > 1 ? stoull(argv[1]) : 64) << 20;
+    mt19937_64 rng{42};
+
+    for (auto [label, period]: {make_pair("clean", size_t{0}), make_pair("1 in 1000", size_t{8000}),
+                                make_pair("1 in 8", size_t{64})}) {
+        auto text = make_text(size, period, rng);
+        auto mb = size / double(1 << 20);
+
+        auto measure = [&](auto f) {
+            BufferSink sink{size * 2};
+            auto start = chrono::steady_clock::now();
+            f(sink);
+            auto time = seconds_since(start);
+            return make_pair(mb / time, sink.take());
+        };
+
+        auto copy = measure([&](HtmlSink &sink) { sink.append(text); });
+        auto naive = measure([&](HtmlSink &sink) { escape_naive(sink, text, true); });
+        auto simd = measure([&](HtmlSink &sink) { escape_html(sink, text, true); });
+
+        Tag tag{"p", text};
+        ostringstream oss;
+        auto start = chrono::steady_clock::now();
+        oss << tag;
+        auto tag_speed = mb / seconds_since(start);
+
+        cout << label << ": " << mb << " MB escaped to " << simd.second.size() / double(1 << 20) << " MB" << endl
+             << "  memcpy:            " << copy.first << " MB/s" << endl
+             << "  per character:     " << naive.first << " MB/s" << endl
+             << "  escape_html:       " << simd.first << " MB/s" << endl
+             << "  Tag, operator<<:   " << tag_speed << " MB/s" << endl;
+
+        if (simd.second != naive.second) {
+            cerr << "escape_html differs from the per-character escaper on " << label << " text" << endl;
+            return 1;
+        }
+    }
+
+    return 0;
+}
@@ -0,0 +1,109 @@
+#include <chrono>
+
+#include "lecture_08_html_template.h"
+#include "bench_util.h"
+
+/**
+ * A product page with four values that change from page to page, and markup that never does.
+ */
+namespace page_template {
+    using namespace html_template;
+
+    static constexpr auto page = el("div",
+        attr("class", "product"),
+        el("h1", slot<0>()),
+        p(img(slot<1>())),
+        p("Price: ", slot<2>()),
+        el("ul",
+            el("li", "Free shipping on orders over $50"),
+            el("li", "30-day returns & exchanges"),
+            el("li", "Ships from our warehouse in Pallet Town")),
+        el("div", attr("class", "description"),
+            p(slot<3>()),
+            p("Questions? Ask Professor Oak.")),
+        el("footer",
+            p("Copyright Pokemon Mart"),
+            p(img("http://pokemon.com/logo.png"))));
+}
+
+/**
+ * The same page as a Tag tree, built for every page like the groovy-style DSL does.
+ */
+Tag product_tag(const string &name, const string &url, const string &price, const string &description) {
+    Tag page{"div", vector<Tag>{
+        Tag{"h1", name},
+        P{IMG{url}},
+        P{"Price: " + price},
+        Tag{"ul", vector<Tag>{
+            Tag{"li", "Free shipping on orders over $50"},
+            Tag{"li", "30-day returns & exchanges"},
+            Tag{"li", "Ships from our warehouse in Pallet Town"}}},
+        Tag{"div", vector<Tag>{
+            P{description},
+            P{"Questions? Ask Professor Oak."}}},
+        Tag{"footer", vector<Tag>{
+            P{"Copyright Pokemon Mart"},
+            P{IMG{"http://pokemon.com/logo.png"}}}}}};
+    page.attributes.emplace_back("class", "product");
+    page.children[4].attributes.emplace_back("class", "description");
+    return page;
+}
+
+/**
+ * Generates pages with the Tag tree (printed with operator<<, and rendered into a sink) and with the compiled
+ * template, checking that every page comes out the same.
+ * Usage: lecture_08_html_template [pages]
+ */
+int main(int argc, char *argv[]) {
+    size_t pages = argc > 1 ? stoull(argv[1]) : 200'000;
+
+    vector<string> names, urls, prices, descriptions;
+    for (size_t i = 0; i < 1000; ++i) {
+        names.push_back("Poke Ball #" + to_string(i));
+        urls.push_back("http://pokemon.com/items?id=" + to_string(i) + "&size=large");
+        prices.push_back("$" + to_string(100 + i) + ".99");
+        descriptions.push_back("A device for catching wild Pokemon, model " + to_string(i)
+                               + (i % 10 ? "." : " & the <b>\"original\"</b>."));
+    }
+
+    size_t mismatches = 0, bytes = 0;
+    auto measure = [&](const char *label, auto generate) {
+        auto start = chrono::steady_clock::now();
+        for (size_t i = 0; i < pages; ++i) {
+            auto k = i % names.size();
+            bytes += generate(names[k], urls[k], prices[k], descriptions[k]).size();
+        }
+        auto time = seconds_since(start);
+        cout << "  " << label << pages / time / 1e6 << " M pages/s, " << bytes / time / (1 << 20) << " MB/s" << endl;
+        bytes = 0;
+
+        for (size_t k = 0; k < names.size(); ++k) {
+            ostringstream oss;
+            oss << product_tag(names[k], urls[k], prices[k], descriptions[k]);
+            mismatches += generate(names[k], urls[k], prices[k], descriptions[k]) != oss.str();
+        }
+    };
+
+    cout << pages << " pages of about " << page_template::page.fragment.bytes << " bytes of static markup in "
+         << page_template::page.fragment.part_count << " parts" << endl;
+    measure("Tag tree, operator<<:  ", [](auto &name, auto &url, auto &price, auto &description) {
+        ostringstream oss;
+        oss << product_tag(name, url, price, description);
+        return oss.str();
+    });
+    measure("Tag tree, render:      ", [](auto &name, auto &url, auto &price, auto &description) {
+        BufferSink sink;
+        product_tag(name, url, price, description).render(sink);
+        return sink.take();
+    });
+    measure("compiled template:     ", [](auto &name, auto &url, auto &price, auto &description) {
+        return html_template::str<page_template::page>(name, url, price, description);
+    });
+
+    if (mismatches) {
+        cerr << mismatches << " pages differ from the Tag tree's" << endl;
+        return 1;
+    }
+
+    return 0;
+}
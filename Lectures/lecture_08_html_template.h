@@ -0,0 +1,230 @@
+#pragma once
+
+#include <string_view>
+#include <type_traits>
+
+#include "html_escape.h"
+#include "lecture_08_groovy_style_builder.h"
+
+/**
+ * COMPILE-TIME HTML TEMPLATES
+ *
+ * The Tag DSL builds a tree of vectors and strings for every page, then walks it to print it, even when the
+ * structure never changes and only a few strings do.
+ *
+ * The same DSL, evaluated at compile time: el, p and img describe the markup, exactly as Tag would print it, and
+ * slot<I>() marks where the I-th runtime value goes (as text or as an attribute value). The whole page folds into
+ * one constant: its static markup as a few literal chunks, merged wherever nothing dynamic comes between them,
+ * and the slots between those chunks. Rendering a page is then one append per chunk and per value.
+ *
+ *     static constexpr auto page = html_template::p(html_template::img(html_template::slot<0>()));
+ *     html_template::render<page>(sink, url);
+ *
+ * Like Tag, the page escapes its text and attribute values: literals once, at compile time, and slot values as they
+ * are written.
+ *
+ * An element may be given several texts (say a literal, then a slot): they are written one after the other, as its
+ * one text. A slot's value is always written as present: a slot used as text gets its line even if the value is empty,
+ * where a Tag with empty text would have none.
+ */
+namespace html_template {
+    struct Part {
+        size_t offset;
+        size_t length;
+        int slot;  // -1 for literal text[offset, offset + length)
+        bool attribute;  // a slot inside an attribute value
+    };
+
+    /**
+     * Markup with room for Bytes characters of literal text and Parts parts.
+     */
+    template <size_t Bytes, size_t Parts> struct Fragment {
+        char text[Bytes + 1]{};
+        Part parts[Parts + 1]{};
+        size_t bytes{0};
+        size_t part_count{0};
+
+        constexpr void add_literal(const char *s, size_t n) {
+            if (n == 0)
+                return;
+            auto &last = parts[part_count > 0 ? part_count - 1 : 0];
+            if (part_count > 0 && last.slot < 0)
+                last.length += n;
+            else
+                parts[part_count++] = {bytes, n, -1, false};
+            for (size_t i = 0; i < n; ++i)
+                text[bytes++] = s[i];
+        }
+
+        /**
+         * Needs room for up to 6 characters (&quot;) per character of s.
+         */
+        constexpr void add_escaped(const char *s, size_t n, bool attribute) {
+            for (size_t i = 0; i < n; ++i) {
+                if (html_escape::needs_escape(s[i], attribute)) {
+                    auto e = html_escape::entity(s[i]);
+                    add_literal(e.data(), e.size());
+                } else {
+                    add_literal(s + i, 1);
+                }
+            }
+        }
+
+        constexpr void add_slot(int slot, bool attribute = false) {
+            parts[part_count++] = {0, 0, slot, attribute};
+        }
+
+        template <size_t B, size_t P> constexpr void add(const Fragment<B, P> &f, bool attribute = false) {
+            for (size_t i = 0; i < f.part_count; ++i) {
+                if (f.parts[i].slot < 0)
+                    add_literal(f.text + f.parts[i].offset, f.parts[i].length);
+                else
+                    add_slot(f.parts[i].slot, attribute || f.parts[i].attribute);
+            }
+        }
+
+        constexpr size_t slot_count() const {
+            size_t count = 0;
+            for (size_t i = 0; i < part_count; ++i)
+                if (parts[i].slot >= 0 && static_cast<size_t>(parts[i].slot) + 1 > count)
+                    count = parts[i].slot + 1;
+            return count;
+        }
+    };
+
+    template <size_t N> constexpr auto literal(const char (&s)[N]) {
+        Fragment<N - 1, 1> f{};
+        f.add_literal(s, N - 1);
+        return f;
+    }
+
+    template <int I> constexpr auto slot() {
+        static_assert(I >= 0, "slots are numbered from 0");
+        Fragment<0, 1> f{};
+        f.add_slot(I);
+        return f;
+    }
+
+    /**
+     * What goes inside an element: its text, an attribute, or a child element.
+     */
+    template <typename F> struct Text { F fragment; };
+    template <typename F> struct Attribute { F fragment; };
+    template <typename F> struct Element { F fragment; };
+
+    template <size_t N> constexpr auto escaped(const char (&s)[N], bool attribute) {
+        Fragment<6 * (N - 1), 1> f{};
+        f.add_escaped(s, N - 1, attribute);
+        return f;
+    }
+
+    template <size_t N> constexpr auto text(const char (&s)[N]) {
+        return Text<decltype(escaped(s, false))>{escaped(s, false)};
+    }
+    template <size_t B, size_t P> constexpr auto text(const Fragment<B, P> &f) { return Text<Fragment<B, P>>{f}; }
+
+    // Element contents: a string literal or a bare slot is text, the rest is what it says.
+    template <size_t N> constexpr auto as_content(const char (&s)[N]) { return text(s); }
+    template <size_t B, size_t P> constexpr auto as_content(const Fragment<B, P> &f) { return text(f); }
+    template <typename F> constexpr auto as_content(const Text<F> &t) { return t; }
+    template <typename F> constexpr auto as_content(const Attribute<F> &a) { return a; }
+    template <typename F> constexpr auto as_content(const Element<F> &e) { return e; }
+
+    template <typename T> struct Size;
+    template <size_t B, size_t P> struct Size<Fragment<B, P>> {
+        static constexpr size_t bytes = B;
+        static constexpr size_t parts = P;
+    };
+    template <template <typename> class Kind, typename F> struct Size<Kind<F>> : Size<F> {};
+
+    template <typename T> using part_t = decltype(as_content(std::declval<const T&>()));
+
+    template <typename T> constexpr bool is_text = false;
+    template <typename F> constexpr bool is_text<Text<F>> = true;
+    template <typename T> constexpr bool is_attribute = false;
+    template <typename F> constexpr bool is_attribute<Attribute<F>> = true;
+    template <typename T> constexpr bool is_element = false;
+    template <typename F> constexpr bool is_element<Element<F>> = true;
+
+    template <size_t N, size_t M> constexpr auto attr(const char (&name)[N], const char (&value)[M]) {
+        return attr(name, escaped(value, true));
+    }
+
+    template <size_t N, size_t B, size_t P> constexpr auto attr(const char (&name)[N], const Fragment<B, P> &value) {
+        Fragment<N + 2 + B, P + 2> f{};
+        f.add_literal(" ", 1);
+        f.add_literal(name, N - 1);
+        f.add_literal("=\"", 2);
+        f.add(value, true);
+        f.add_literal("\"", 1);
+        return Attribute<decltype(f)>{f};
+    }
+
+    /**
+     * <name attributes>, text, children, </name>, laid out like operator<<(ostream&, const Tag&).
+     */
+    template <size_t N, typename... Contents> constexpr auto el(const char (&name)[N], const Contents&... contents) {
+        constexpr size_t bytes = 2 * (N - 1) + 8 + (0 + ... + Size<part_t<Contents>>::bytes);
+        constexpr size_t parts = 4 + 2 * sizeof...(Contents) + (0 + ... + Size<part_t<Contents>>::parts);
+        constexpr bool has_text = (false || ... || is_text<part_t<Contents>>);
+        constexpr bool has_children = (false || ... || is_element<part_t<Contents>>);
+
+        Fragment<bytes, parts> f{};
+        f.add_literal("<", 1);
+        f.add_literal(name, N - 1);
+        auto add_if = [&f](auto part, bool wanted) {
+            if (wanted)
+                f.add(part.fragment);
+        };
+        (add_if(as_content(contents), is_attribute<part_t<Contents>>), ...);
+
+        if (!has_text && !has_children) {
+            f.add_literal("/>\n", 3);
+        } else {
+            f.add_literal(">\n", 2);
+            if (has_text) {
+                (add_if(as_content(contents), is_text<part_t<Contents>>), ...);
+                f.add_literal("\n", 1);
+            }
+            (add_if(as_content(contents), is_element<part_t<Contents>>), ...);
+            f.add_literal("</", 2);
+            f.add_literal(name, N - 1);
+            f.add_literal(">\n", 2);
+        }
+        return Element<decltype(f)>{f};
+    }
+
+    /**
+     * The tags of the runtime DSL.
+     */
+    template <typename... Contents> constexpr auto p(const Contents&... contents) {
+        return el("p", contents...);
+    }
+
+    template <typename Url> constexpr auto img(const Url &url) {
+        return el("img", attr("src", url));
+    }
+
+    /**
+     * Writes the page, with values[I] for slot I.
+     */
+    template <const auto &Page, typename... Values> void render(HtmlSink &sink, const Values&... values) {
+        constexpr auto &f = Page.fragment;
+        static_assert(f.slot_count() == sizeof...(Values), "one value per slot");
+
+        const string_view slots[sizeof...(Values) + 1] = {string_view{values}...};
+        for (size_t i = 0; i < f.part_count; ++i) {
+            const auto &part = f.parts[i];
+            if (part.slot < 0)
+                sink.append(string_view{f.text + part.offset, part.length});
+            else
+                escape_html(sink, slots[part.slot], part.attribute);
+        }
+    }
+
+    template <const auto &Page, typename... Values> string str(const Values&... values) {
+        BufferSink sink;
+        render<Page>(sink, values...);
+        return sink.take();
+    }
+}
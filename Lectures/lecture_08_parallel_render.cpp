@@ -0,0 +1,81 @@
+#include <chrono>
+
+#include "lecture_06_builder.h"
+#include "lecture_08_groovy_style_builder.h"
+#include "parallel_render.h"
+#include "bench_util.h"
+
+/**
+ * A wide HtmlElement document: sections of list items under one root.
+ */
+HtmlElement wide_elements(size_t sections, size_t items) {
+    HtmlElement root{"body", ""};
+    root.elements.reserve(sections);
+    for (size_t s = 0; s < sections; ++s) {
+        HtmlElement section{"ul", "section " + to_string(s)};
+        section.elements.reserve(items);
+        for (size_t i = 0; i < items; ++i)
+            section.elements.emplace_back("li", "item " + to_string(i) + " of section " + to_string(s));
+        root.elements.push_back(std::move(section));
+    }
+    return root;
+}
+
+/**
+ * The same shape with the Tag DSL: paragraphs of text and images under one root.
+ */
+Tag wide_tags(size_t sections, size_t items) {
+    vector<Tag> paragraphs;
+    paragraphs.reserve(sections);
+    for (size_t s = 0; s < sections; ++s) {
+        vector<Tag> children;
+        children.reserve(items);
+        for (size_t i = 0; i < items; ++i) {
+            if (i % 4 == 0)
+                children.push_back(IMG{"http://pokemon.com/" + to_string(s) + "/" + to_string(i) + ".png"});
+            else
+                children.push_back(P{"paragraph " + to_string(i) + " of section " + to_string(s)});
+        }
+        paragraphs.emplace_back("p", children);
+    }
+    return Tag{"body", paragraphs};
+}
+
+/**
+ * Renders both documents with 1, 2, 4, ... threads, checking each output against the sequential renderer.
+ * Usage: lecture_08_parallel_render [sections] [items per section] [threshold]
+ */
+int main(int argc, char *argv[]) {
+    size_t sections = argc > 1 ? stoull(argv[1]) : 1'000;
+    size_t items = argc > 2 ? stoull(argv[2]) : 1'000;
+    size_t threshold = argc > 3 ? stoull(argv[3]) : 4'096;
+
+    auto sweep = [&](const char *label, const auto &root, const string &expected) {
+        cout << label << ", " << expected.size() / double(1 << 20) << " MB" << endl;
+        auto max_threads = max<size_t>(4, thread::hardware_concurrency());
+        for (size_t threads = 1; threads <= max_threads; threads *= 2) {
+            WorkerPool pool{threads};
+            ParallelRenderer<std::decay_t<decltype(root)>> renderer{pool, threshold};
+            auto start = chrono::steady_clock::now();
+            auto html = renderer.str(root);
+            auto time = seconds_since(start);
+            cout << "  " << threads << " thread(s): " << time * 1e3 << " ms" << endl;
+            if (html != expected) {
+                cerr << "Parallel render with " << threads << " threads differs from the sequential one" << endl;
+                return false;
+            }
+        }
+        return true;
+    };
+
+    auto elements = wide_elements(sections, items);
+    auto tags = wide_tags(sections, items);
+
+    ostringstream oss;
+    oss << tags;
+
+    if (!sweep("HtmlElement", elements, elements.str()) || !sweep("Tag", tags, oss.str()))
+        return 1;
+
+    return 0;
+}
@@ -0,0 +1,125 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include "html_sink.h"
+#include "worker_pool.h"
+
+/**
+ * Renders a tree of any Node with a RenderTraits specialization on a WorkerPool, with exactly the bytes the
+ * sequential renderer writes.
+ *
+ * A first pass counts the elements in every subtree. The tree is then cut into tasks: a run of consecutive
+ * siblings holding about threshold elements together, or one bigger subtree, which is cut further in the same
+ * way. The opening and closing of the elements above the cut are rendered on the calling thread. The tasks render
+ * into buffers of their own on the pool, whose threads keep taking the next task until none are left, so a few
+ * big tasks do not hold up the rest. The buffers are then appended to the sink in document order.
+ */
+template <typename Node> class ParallelRenderer {
+    using Traits = RenderTraits<Node>;
+
+    // Children [first, last) of parent, rendered into pieces[piece].
+    struct Task {
+        const Node *parent;
+        size_t first, last;
+        int depth;
+        size_t piece;
+    };
+
+    struct Plan {
+        std::vector<std::string> pieces;
+        std::vector<Task> tasks;
+    };
+
+    WorkerPool &pool;
+    size_t threshold;
+
+    /**
+     * Element counts of every subtree, in pre-order, so that a node's children follow it and each child's
+     * subtree is skipped by adding its count.
+     */
+    static size_t count(const Node &node, std::vector<size_t> &sizes) {
+        auto index = sizes.size();
+        sizes.push_back(0);
+        size_t total = 1;
+        for (const auto &child: Traits::children(node))
+            total += count(child, sizes);
+        sizes[index] = total;
+        return total;
+    }
+
+    static void render_subtree(const Node &node, HtmlSink &sink, int depth) {
+        Traits::open(node, sink, depth);
+        for (const auto &child: Traits::children(node))
+            render_subtree(child, sink, depth + 1);
+        Traits::close(node, sink, depth);
+    }
+
+    void plan(const Node &node, size_t index, int depth, const std::vector<size_t> &sizes, Plan &p) const {
+        BufferSink glue;
+        Traits::open(node, glue, depth);
+        p.pieces.push_back(glue.take());
+
+        const auto &children = Traits::children(node);
+        size_t run_first = 0, run_size = 0;
+        auto end_run = [&](size_t last) {
+            if (run_first < last) {
+                p.tasks.push_back({&node, run_first, last, depth + 1, p.pieces.size()});
+                p.pieces.emplace_back();
+            }
+            run_first = last;
+            run_size = 0;
+        };
+
+        auto child_index = index + 1;
+        for (size_t c = 0; c < children.size(); ++c) {
+            auto size = sizes[child_index];
+            if (size > threshold) {
+                end_run(c);
+                plan(children[c], child_index, depth + 1, sizes, p);
+                run_first = c + 1;
+            } else if ((run_size += size) >= threshold) {
+                end_run(c + 1);
+            }
+            child_index += size;
+        }
+        end_run(children.size());
+
+        Traits::close(node, glue, depth);
+        p.pieces.push_back(glue.take());
+    }
+
+public:
+    explicit ParallelRenderer(WorkerPool &pool, size_t threshold = 4096)
+            : pool(pool), threshold(std::max<size_t>(threshold, 1)) {}
+
+    void render(const Node &root, HtmlSink &sink) const {
+        std::vector<size_t> sizes;
+        if (pool.size() == 1 || count(root, sizes) <= threshold) {
+            render_subtree(root, sink, 0);
+            return;
+        }
+
+        Plan p;
+        plan(root, 0, 0, sizes, p);
+
+        pool.parallel_for(p.tasks.size(), [&p](size_t t) {
+            const auto &task = p.tasks[t];
+            const auto &children = Traits::children(*task.parent);
+            BufferSink out;
+            for (auto c = task.first; c < task.last; ++c)
+                render_subtree(children[c], out, task.depth);
+            p.pieces[task.piece] = out.take();
+        });
+
+        for (const auto &piece: p.pieces)
+            sink.append(piece);
+    }
+
+    std::string str(const Node &root) const {
+        BufferSink sink;
+        render(root, sink);
+        return sink.take();
+    }
+};
@@ -0,0 +1,131 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/**
+ * A fixed set of worker threads that run parallel_for loops.
+ *
+ * parallel_for(count, f) calls f(0), ..., f(count - 1) spread over the workers and the calling thread, which
+ * claim indices from a shared counter, so uneven tasks balance themselves. It returns once every call is done.
+ * Only one parallel_for runs at a time on a pool.
+ *
+ * f may throw, on any thread. The first exception stops the loop: no further indices are handed out, calls already
+ * running finish, and parallel_for rethrows it on the calling thread once no thread is using f any more. Later
+ * exceptions from the same loop are dropped.
+ */
+class WorkerPool {
+    std::vector<std::thread> workers;
+
+    std::mutex mutex;
+    std::condition_variable work_ready;
+    std::condition_variable work_done;
+
+    const std::function<void(size_t)> *job{nullptr};
+    size_t job_count{0};
+    std::atomic<size_t> next{0};
+    size_t busy{0};
+    size_t generation{0};
+    bool stopping{false};
+    std::exception_ptr error;
+
+    void drain(const std::function<void(size_t)> &f, size_t count) {
+        try {
+            for (size_t i = next++; i < count; i = next++)
+                f(i);
+        } catch (...) {
+            std::lock_guard<std::mutex> lock{mutex};
+            if (!error)
+                error = std::current_exception();
+            next = count;
+        }
+    }
+
+    void run() {
+        size_t seen = 0;
+        for (;;) {
+            const std::function<void(size_t)> *f;
+            size_t count;
+            {
+                std::unique_lock<std::mutex> lock{mutex};
+                work_ready.wait(lock, [&] { return stopping || generation != seen; });
+                if (stopping)
+                    return;
+                seen = generation;
+                // A worker that wakes up only after the loop has returned finds no job: the function it pointed to
+                // is gone.
+                if (!job)
+                    continue;
+                f = job;
+                count = job_count;
+                ++busy;
+            }
+
+            drain(*f, count);
+
+            std::lock_guard<std::mutex> lock{mutex};
+            if (--busy == 0)
+                work_done.notify_all();
+        }
+    }
+
+public:
+    /**
+     * threads is the total parallelism including the calling thread, so WorkerPool{1} starts no workers.
+     */
+    explicit WorkerPool(size_t threads = std::thread::hardware_concurrency()) {
+        for (size_t i = 1; i < threads; ++i)
+            workers.emplace_back([this] { run(); });
+    }
+
+    ~WorkerPool() {
+        {
+            std::lock_guard<std::mutex> lock{mutex};
+            stopping = true;
+        }
+        work_ready.notify_all();
+        for (auto &w: workers)
+            w.join();
+    }
+
+    WorkerPool(const WorkerPool&) = delete;
+    WorkerPool &operator=(const WorkerPool&) = delete;
+
+    size_t size() const { return workers.size() + 1; }
+
+    void parallel_for(size_t count, const std::function<void(size_t)> &f) {
+        if (workers.empty() || count <= 1) {
+            for (size_t i = 0; i < count; ++i)
+                f(i);
+            return;
+        }
+
+        {
+            std::lock_guard<std::mutex> lock{mutex};
+            job = &f;
+            job_count = count;
+            next = 0;
+            ++generation;
+        }
+        work_ready.notify_all();
+
+        drain(f, count);
+
+        // No worker is left holding f once busy is 0 and job is cleared, so f can go away and the next loop can
+        // reset the counter. That holds when f threw too, since drain catches.
+        std::exception_ptr failed;
+        {
+            std::unique_lock<std::mutex> lock{mutex};
+            work_done.wait(lock, [this] { return busy == 0; });
+            job = nullptr;
+            std::swap(failed, error);
+        }
+        if (failed)
+            std::rethrow_exception(failed);
+    }
+};